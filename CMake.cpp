@@ -27,18 +27,29 @@
 
 // C++
 #include <utility>
+#include <set>
+#include <algorithm>
 
 // wxWidgets
 #include <wx/regex.h>
+#include <wx/tokenzr.h>
 #include <wx/event.h>
 #include <wx/thread.h>
 #include <wx/scopedptr.h>
+#include <wx/stdpaths.h>
 
-// Codelite
-#include "procutils.h"
-#include "workspace.h"
-#include "globals.h"
-#include "file_logger.h"
+// CMakePlugin
+#include "CMakeCoreHost.h"
+
+/* ************************************************************************ */
+/* VARIABLES                                                                */
+/* ************************************************************************ */
+
+/// Number of help pages kept in memory in lazy mode.
+static const size_t PAGE_CACHE_SIZE = 32;
+
+/// Maximum number of help loading workers, each runs a cmake process.
+static const int MAX_LOAD_WORKERS = 4;
 
 /* ************************************************************************ */
 /* FUNCTIONS                                                                */
@@ -69,14 +80,356 @@ static wxString CreateHtml(const wxArrayString& array)
     return result;
 }
 
+/* ************************************************************************ */
+
+/**
+ * @brief Returns cmake option that prints help pages of all items of
+ * given type.
+ *
+ * @param type Help type.
+ *
+ * @return Option.
+ */
+static wxString GetBulkOption(const wxString& type)
+{
+    // Irregular plural
+    if (type == "property")
+        return "--help-properties";
+
+    return "--help-" + type + "s";
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Returns version of the best available SQLite full-text module.
+ *
+ * @param db Opened database.
+ *
+ * @return 5, 4 or 0 if there is no full-text module.
+ */
+static int FindFtsVersion(wxSQLite3Database& db)
+{
+    static const int versions[] = { 5, 4 };
+
+    for (size_t i = 0; i < sizeof(versions) / sizeof(versions[0]); ++i) {
+        try {
+            // Creating a temporary table is the only portable test
+            db.ExecuteUpdate(wxString::Format("CREATE VIRTUAL TABLE temp.help_fts_probe USING fts%d(text)", versions[i]));
+            db.ExecuteUpdate("DROP TABLE temp.help_fts_probe");
+            return versions[i];
+        } catch (const wxSQLite3Exception&) {
+            // Module is not available
+        }
+    }
+
+    return 0;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Returns version of full-text module used by table.
+ *
+ * @param sql SQL statement that created the table.
+ *
+ * @return 5, 4 or 0 if it's not a full-text table.
+ */
+static int GetFtsVersion(const wxString& sql)
+{
+    const wxString lower = sql.Lower();
+
+    if (lower.Contains("using fts5"))
+        return 5;
+
+    if (lower.Contains("using fts4"))
+        return 4;
+
+    return 0;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Checks if line is a title underline (CMake 3 help format).
+ *
+ * @param line Tested line.
+ *
+ * @return If line consists only of one repeated underline character.
+ */
+static bool IsUnderline(const wxString& line)
+{
+    if (line.IsEmpty())
+        return false;
+
+    const wxUniChar ch = line[0];
+
+    if (ch != '-' && ch != '=' && ch != '*' && ch != '^' && ch != '~')
+        return false;
+
+    for (wxString::const_iterator it = line.begin(), ite = line.end(); it != ite; ++it) {
+        if (*it != ch)
+            return false;
+    }
+
+    return true;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Splits help output of multiple items into separate pages.
+ *
+ * Two formats are supported. CMake 2.x prints name indented by two
+ * spaces followed by description indented by more spaces. CMake 3.x
+ * prints name without indentation followed by title underline.
+ *
+ * @param lines Help output.
+ * @param names Names of items which pages are extracted.
+ * @param pages Output pages.
+ */
+static void SplitHelp(const wxArrayString& lines, const std::set<wxString>& names,
+                      std::map<wxString, wxArrayString>& pages)
+{
+    // Currently filled page
+    wxArrayString* page = NULL;
+
+    // If current page uses indented format
+    bool indented = false;
+
+    for (size_t i = 0; i < lines.GetCount(); ++i) {
+        const wxString& line = lines[i];
+
+        // Trimmed line
+        wxString name = line;
+        name.Trim().Trim(false);
+
+        if (names.count(name)) {
+            const bool old = line.StartsWith("  ") && !line.StartsWith("   ");
+            const bool rst = !line.StartsWith(" ") && i + 1 < lines.GetCount() && IsUnderline(lines[i + 1]);
+
+            // New page found
+            if (old || rst) {
+                indented = old;
+
+                // Only the first occurrence is used
+                if (pages.count(name)) {
+                    page = NULL;
+                } else {
+                    page = &pages[name];
+                    page->Add(line);
+                }
+
+                continue;
+            }
+        }
+
+        // Outside of any page
+        if (!page)
+            continue;
+
+        // Not indented line ends indented page (section title)
+        if (indented && !line.IsEmpty() && !line.StartsWith(" ") && !line.StartsWith("\t")) {
+            page = NULL;
+            continue;
+        }
+
+        page->Add(line);
+    }
+
+    // Remove trailing empty lines
+    for (std::map<wxString, wxArrayString>::iterator it = pages.begin(), ite = pages.end(); it != ite; ++it) {
+        wxArrayString& text = it->second;
+
+        while (!text.IsEmpty() && wxString(text.Last()).Trim().IsEmpty())
+            text.RemoveAt(text.GetCount() - 1);
+    }
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Loads help page of single item.
+ *
+ * @param command Path to cmake.
+ * @param type    Help type.
+ * @param name    Item name.
+ *
+ * @return Help page or empty string.
+ */
+static wxString LoadItemHelp(const wxString& command, const wxString& type,
+                             const wxString& name)
+{
+    // Export help
+    wxArrayString desc;
+    const wxString cmdItem = command + " --help-" + type + " \"" + name + "\"";
+    CMakeCoreHost::Get().Execute(cmdItem, desc);
+
+    // Skip empty results
+    if (desc.IsEmpty())
+        return wxEmptyString;
+
+    // Remove first line (cmake version)
+    if (desc.Item(0).Matches("*cmake version*"))
+        desc.RemoveAt(0);
+
+    return CreateHtml(desc);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Removes help pages from list, only names are kept.
+ *
+ * @param list
+ */
+static void ClearPages(CMake::HelpMap& list)
+{
+    for (CMake::HelpMap::iterator it = list.begin(), ite = list.end(); it != ite; ++it) {
+        it->second.clear();
+    }
+}
+
+/* ************************************************************************ */
+/* STRUCTURES                                                               */
+/* ************************************************************************ */
+
+/**
+ * @brief State shared by help loading workers.
+ */
+struct LoadJobs
+{
+    /// Path to cmake.
+    wxString command;
+
+    /// Help type.
+    wxString type;
+
+    /// Names of loaded items.
+    wxArrayString names;
+
+    /// Loaded help pages in names order.
+    wxVector<wxString> pages;
+
+    /// Guards the members below and the pages.
+    wxMutex mutex;
+
+    /// Signaled when an item is finished.
+    wxCondition finishedCond;
+
+    /// Index of the next item to load.
+    size_t next;
+
+    /// Number of finished items.
+    size_t finished;
+
+    /// Loading should be stopped.
+    bool stop;
+
+
+    /**
+     * @brief Constructor.
+     */
+    LoadJobs()
+        : finishedCond(mutex), next(0), finished(0), stop(false)
+    {}
+};
+
 /* ************************************************************************ */
 /* CLASSES                                                                  */
 /* ************************************************************************ */
 
+/**
+ * @brief Worker thread that loads help pages of items one by one.
+ */
+class LoadWorker : public wxThread
+{
+public:
+
+
+    /**
+     * @brief Constructor.
+     *
+     * @param jobs Shared jobs.
+     */
+    explicit LoadWorker(LoadJobs& jobs)
+        : wxThread(wxTHREAD_JOINABLE)
+        , m_jobs(jobs)
+    {}
+
+
+    /**
+     * @brief Loads items until there is nothing to do or stop
+     * is requested.
+     *
+     * @param notifier Notifier asked for stop before each item, only
+     *                 when processing in the thread that owns it.
+     */
+    void Process(CMake::LoadNotifier* notifier = NULL)
+    {
+        while (true) {
+            size_t index;
+
+            // Stop request
+            if (notifier && notifier->RequestStop()) {
+                wxMutexLocker lock(m_jobs.mutex);
+                m_jobs.stop = true;
+                break;
+            }
+
+            // Take next item
+            {
+                wxMutexLocker lock(m_jobs.mutex);
+
+                if (m_jobs.stop || m_jobs.next >= m_jobs.names.GetCount())
+                    break;
+
+                index = m_jobs.next++;
+            }
+
+            const wxString page = LoadItemHelp(m_jobs.command, m_jobs.type, m_jobs.names[index]);
+
+            // Store result
+            {
+                wxMutexLocker lock(m_jobs.mutex);
+                m_jobs.pages[index] = page.Clone();
+                m_jobs.finished++;
+                m_jobs.finishedCond.Signal();
+            }
+        }
+    }
+
+
+protected:
+
+
+    /**
+     * @brief Thread entry.
+     *
+     * @return Exit code.
+     */
+    virtual ExitCode Entry()
+    {
+        Process();
+        return static_cast<ExitCode>(0);
+    }
+
+
+private:
+
+    /// Shared jobs.
+    LoadJobs& m_jobs;
+};
+
+/* ************************************************************************ */
+
 CMake::CMake(const wxFileName& path)
     : m_path(path)
-    , m_version("?")
+    , m_version()
     , m_dbFileName(wxStandardPaths::Get().GetUserDataDir(), "cmake.db")
+    , m_installation(-1)
+    , m_ftsVersion(0)
+    , m_lazy(true)
 {
     // Prepare database
     PrepareDatabase();
@@ -121,13 +474,205 @@ CMake::GetVersions()
 
 /* ************************************************************************ */
 
+wxString
+CMake::GetHelp(const HelpMap& list, const wxString& name)
+{
+    // Unknown item
+    HelpMap::const_iterator item = list.find(name);
+
+    if (item == list.end())
+        return wxEmptyString;
+
+    // Page is stored in the list
+    if (!item->second.IsEmpty())
+        return item->second;
+
+    // Find table and help type
+    wxString table;
+    wxString type;
+
+    if (!GetListInfo(list, table, type))
+        return wxEmptyString;
+
+    const wxString key = table + "/" + name;
+
+    // Find in recently used pages
+    for (PageCache::iterator it = m_pageCache.begin(), ite = m_pageCache.end(); it != ite; ++it) {
+        if (it->first == key) {
+            // Move to front
+            m_pageCache.splice(m_pageCache.begin(), m_pageCache, it);
+            return m_pageCache.front().second;
+        }
+    }
+
+    // Load from database, cmake is not run here because it's slow
+    const wxString page = LoadPageFromDatabase(table, name);
+
+    if (!page.IsEmpty())
+        AddHelp(list, name, page);
+
+    return page;
+}
+
+/* ************************************************************************ */
+
+wxString
+CMake::LoadHelp(const HelpMap& list, const wxString& name) const
+{
+    wxString table;
+    wxString type;
+
+    if (!GetListInfo(list, table, type))
+        return wxEmptyString;
+
+    return LoadItemHelp(GetPath().GetFullPath(), type, name);
+}
+
+/* ************************************************************************ */
+
+void
+CMake::AddHelp(const HelpMap& list, const wxString& name, const wxString& page)
+{
+    wxString table;
+    wxString type;
+
+    if (page.IsEmpty() || !GetListInfo(list, table, type))
+        return;
+
+    // Store into cache and remove the least recently used page
+    m_pageCache.push_front(std::make_pair(table + "/" + name, page));
+
+    if (m_pageCache.size() > PAGE_CACHE_SIZE)
+        m_pageCache.pop_back();
+}
+
+/* ************************************************************************ */
+
+CMake::SearchResult
+CMake::Search(const wxString& text, const HelpMap* list, int limit) const
+{
+    SearchResult result;
+
+    if (!m_dbInitialized || !m_ftsVersion || m_installation < 0)
+        return result;
+
+    // Build query, each word is quoted and the last one is a prefix
+    const wxArrayString words = wxStringTokenize(text, " \t");
+    wxString query;
+
+    for (wxArrayString::const_iterator it = words.begin(), ite = words.end(); it != ite; ++it) {
+        wxString word = *it;
+        word.Replace("\"", "\"\"");
+
+        if (!query.IsEmpty())
+            query += " ";
+
+        // FTS5 uses "word"* for prefix, FTS4 only word* or "word*"
+        if (it + 1 != ite)
+            query += "\"" + word + "\"";
+        else if (m_ftsVersion == 5)
+            query += "\"" + word + "\"*";
+        else
+            query += "\"" + word + "*\"";
+    }
+
+    if (query.IsEmpty())
+        return result;
+
+    // Search only in one table
+    wxString table;
+    wxString type;
+
+    if (list && !GetListInfo(*list, table, type))
+        return result;
+
+    wxString sql = "SELECT topic, name FROM help_fts WHERE help_fts MATCH ? AND installation = ?";
+
+    if (list)
+        sql += " AND topic = ?";
+
+    // Name is more relevant than description
+    if (m_ftsVersion == 5)
+        sql += " ORDER BY bm25(help_fts, 0.0, 0.0, 10.0, 1.0)";
+    else
+        sql += " ORDER BY name";
+
+    sql += " LIMIT ?";
+
+    try
+    {
+        /// Open database only for reading
+        wxSQLite3Database db;
+
+        // Open
+        db.Open(GetDatabaseFileName().GetFullPath());
+
+        // Not opened
+        if (!db.IsOpen())
+            return result;
+
+        wxSQLite3Statement stmt = db.PrepareStatement(sql);
+        int param = 1;
+        stmt.Bind(param++, query);
+        stmt.Bind(param++, m_installation);
+
+        if (list)
+            stmt.Bind(param++, table);
+
+        stmt.Bind(param++, limit);
+
+        wxSQLite3ResultSet res = stmt.ExecuteQuery();
+        while (res.NextRow()) {
+            const wxString topic = res.GetAsString(0);
+            const SearchHit hit = {
+                topic == "commands" ? &m_commands :
+                topic == "modules" ? &m_modules :
+                topic == "properties" ? &m_properties : &m_variables,
+                res.GetAsString(1)
+            };
+            result.push_back(hit);
+        }
+
+    } catch (const wxSQLite3Exception& e) {
+        CMAKE_ERROR("Error occured while searching CMake database: %s", e.GetMessage());
+    }
+
+    return result;
+}
+
+/* ************************************************************************ */
+
+bool
+CMake::GetListInfo(const HelpMap& list, wxString& table, wxString& type) const
+{
+    if (&list == &m_commands) {
+        table = "commands";
+        type = "command";
+    } else if (&list == &m_modules) {
+        table = "modules";
+        type = "module";
+    } else if (&list == &m_properties) {
+        table = "properties";
+        type = "property";
+    } else if (&list == &m_variables) {
+        table = "variables";
+        type = "variable";
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+/* ************************************************************************ */
+
 bool
 CMake::IsOk() const
 {
     wxArrayString output;
-    ProcUtils::SafeExecuteCommand(GetPath().GetFullPath() + " -h", output);
+    CMakeCoreHost::Get().Execute(GetPath().GetFullPath() + " -h", output);
 
-    // SafeExecuteCommand doesn't return status code so the only way
+    // Execute doesn't return status code so the only way
     // to test the success is the output emptiness.
     return !output.empty();
 }
@@ -138,16 +683,24 @@ bool
 CMake::LoadData(bool force, LoadNotifier* notifier)
 {
     // Clear old data
-    m_version.clear();
     m_commands.clear();
     m_modules.clear();
     m_properties.clear();
     m_variables.clear();
+    m_pageCache.clear();
+    m_installation = -1;
 
     if (notifier) {
         notifier->Start();
     }
 
+    // Version identifies data in the database, cmake is called only
+    // when the path is changed or the version is unknown
+    if (force || m_version.IsEmpty() || m_versionPath != GetPath().GetFullPath()) {
+        m_version = LoadVersion();
+        m_versionPath = GetPath().GetFullPath();
+    }
+
     // Load data from database
     if (!force && m_dbInitialized && LoadFromDatabase()) {
         // Loading is done
@@ -166,30 +719,6 @@ CMake::LoadData(bool force, LoadNotifier* notifier)
         return false;
     }
 
-    // Get cmake program path
-    const wxString program = GetPath().GetFullPath();
-
-    // Version
-    {
-        wxArrayString output;
-        ProcUtils::SafeExecuteCommand(program + " --version", output);
-
-        // Unable to find version
-        if (!output.IsEmpty()) {
-            const wxString& versionLine = output[0];
-            wxRegEx expression("cmake version (.+)");
-
-            if (expression.IsValid() && expression.Matches(versionLine)) {
-                m_version = expression.GetMatch(versionLine, 1).Trim().Trim(false);
-            }
-        }
-    }
-
-    // Request to stop
-    if (notifier && notifier->RequestStop()) {
-        return false;
-    }
-
     // Load data
     LoadFromCMake(notifier);
 
@@ -199,8 +728,12 @@ CMake::LoadData(bool force, LoadNotifier* notifier)
     }
 
     // Database is open so we can store result into database
-    if (m_dbInitialized) {
-        StoreIntoDatabase();
+    if (m_dbInitialized && StoreIntoDatabase() && m_lazy) {
+        // Pages are loaded from database on demand
+        ClearPages(m_commands);
+        ClearPages(m_modules);
+        ClearPages(m_properties);
+        ClearPages(m_variables);
     }
 
     // Loading is done
@@ -214,6 +747,27 @@ CMake::LoadData(bool force, LoadNotifier* notifier)
 
 /* ************************************************************************ */
 
+wxString
+CMake::LoadVersion() const
+{
+    wxArrayString output;
+    CMakeCoreHost::Get().Execute(GetPath().GetFullPath() + " --version", output);
+
+    // Unable to find version
+    if (output.IsEmpty())
+        return wxEmptyString;
+
+    const wxString& versionLine = output[0];
+    wxRegEx expression("cmake version (.+)");
+
+    if (!expression.IsValid() || !expression.Matches(versionLine))
+        return wxEmptyString;
+
+    return expression.GetMatch(versionLine, 1).Trim().Trim(false);
+}
+
+/* ************************************************************************ */
+
 void
 CMake::PrepareDatabase()
 {
@@ -231,26 +785,67 @@ CMake::PrepareDatabase()
         if (!db.IsOpen())
             return;
 
+        // Schema version 0 stores data of single installation only
+        if (db.ExecuteScalar("PRAGMA user_version") < 1) {
+            db.ExecuteUpdate("DROP TABLE IF EXISTS commands");
+            db.ExecuteUpdate("DROP TABLE IF EXISTS modules");
+            db.ExecuteUpdate("DROP TABLE IF EXISTS properties");
+            db.ExecuteUpdate("DROP TABLE IF EXISTS variables");
+            db.ExecuteUpdate("DROP TABLE IF EXISTS strings");
+            db.ExecuteUpdate("PRAGMA user_version = 1");
+        }
+
         // Create tables
-        db.ExecuteUpdate("CREATE TABLE IF NOT EXISTS commands (name TEXT, desc TEXT)");
-        db.ExecuteUpdate("CREATE TABLE IF NOT EXISTS modules (name TEXT, desc TEXT)");
-        db.ExecuteUpdate("CREATE TABLE IF NOT EXISTS properties (name TEXT, desc TEXT)");
-        db.ExecuteUpdate("CREATE TABLE IF NOT EXISTS variables (name TEXT, desc TEXT)");
-        db.ExecuteUpdate("CREATE TABLE IF NOT EXISTS strings (name TEXT, desc TEXT)");
+        db.ExecuteUpdate("CREATE TABLE IF NOT EXISTS installations (id INTEGER PRIMARY KEY, path TEXT, version TEXT)");
+        db.ExecuteUpdate("CREATE TABLE IF NOT EXISTS commands (installation INTEGER, name TEXT, desc TEXT)");
+        db.ExecuteUpdate("CREATE TABLE IF NOT EXISTS modules (installation INTEGER, name TEXT, desc TEXT)");
+        db.ExecuteUpdate("CREATE TABLE IF NOT EXISTS properties (installation INTEGER, name TEXT, desc TEXT)");
+        db.ExecuteUpdate("CREATE TABLE IF NOT EXISTS variables (installation INTEGER, name TEXT, desc TEXT)");
 
         // Create indices
-        db.ExecuteUpdate("CREATE UNIQUE INDEX IF NOT EXISTS commands_idx ON commands(name)");
-        db.ExecuteUpdate("CREATE UNIQUE INDEX IF NOT EXISTS modules_idx ON modules(name)");
-        db.ExecuteUpdate("CREATE UNIQUE INDEX IF NOT EXISTS properties_idx ON properties(name)");
-        db.ExecuteUpdate("CREATE UNIQUE INDEX IF NOT EXISTS variables_idx ON variables(name)");
-        db.ExecuteUpdate("CREATE UNIQUE INDEX IF NOT EXISTS strings_idx ON strings(name)");
+        db.ExecuteUpdate("CREATE UNIQUE INDEX IF NOT EXISTS installations_idx ON installations(path, version)");
+        db.ExecuteUpdate("CREATE UNIQUE INDEX IF NOT EXISTS commands_idx ON commands(installation, name)");
+        db.ExecuteUpdate("CREATE UNIQUE INDEX IF NOT EXISTS modules_idx ON modules(installation, name)");
+        db.ExecuteUpdate("CREATE UNIQUE INDEX IF NOT EXISTS properties_idx ON properties(installation, name)");
+        db.ExecuteUpdate("CREATE UNIQUE INDEX IF NOT EXISTS variables_idx ON variables(installation, name)");
 
         // Everything is OK
         m_dbInitialized = true;
 
+        // Full-text index, SQLite can be compiled without FTS modules
+        m_ftsVersion = FindFtsVersion(db);
+
+        // Index created by other module (e.g. by build without FTS5)
+        // must be recreated, it's filled again on next load
+        {
+            wxSQLite3ResultSet res = db.ExecuteQuery("SELECT sql FROM sqlite_master WHERE name = 'help_fts'");
+
+            if (res.NextRow() && GetFtsVersion(res.GetAsString(0)) != m_ftsVersion) {
+                res.Finalize();
+
+                try {
+                    db.ExecuteUpdate("DROP TABLE help_fts");
+                } catch (const wxSQLite3Exception& e) {
+                    // Table of unavailable module cannot be dropped
+                    CMAKE_WARNING("CMake: unable to recreate full-text index: %s", e.GetMessage());
+                    m_ftsVersion = 0;
+                }
+            }
+        }
+
+        if (m_ftsVersion == 5) {
+            db.ExecuteUpdate("CREATE VIRTUAL TABLE IF NOT EXISTS help_fts USING fts5("
+                "installation UNINDEXED, topic UNINDEXED, name, desc)");
+        } else if (m_ftsVersion == 4) {
+            db.ExecuteUpdate("CREATE VIRTUAL TABLE IF NOT EXISTS help_fts USING fts4("
+                "installation, topic, name, desc, notindexed=installation, notindexed=topic)");
+        } else {
+            CMAKE_WARNING("CMake: full-text search is not available");
+        }
+
     } catch (const wxSQLite3Exception& e) {
         // Unable to use SQLite database
-        CL_ERROR("CMake DoPrepareDatabase error: %s", e.GetMessage());
+        CMAKE_ERROR("CMake DoPrepareDatabase error: %s", e.GetMessage());
     }
 }
 
@@ -298,6 +893,20 @@ CMake::LoadFromDatabase()
         return false;
     }
 
+    // Data of unknown version cannot be identified
+    if (m_version.IsEmpty()) {
+        return false;
+    }
+
+    // Stored tables
+    const std::pair<wxString, HelpMap*> tables[] = {
+        std::make_pair("commands", &m_commands),
+        std::make_pair("modules", &m_modules),
+        std::make_pair("properties", &m_properties),
+        std::make_pair("variables", &m_variables)
+    };
+    const int tablesCount = sizeof(tables) / sizeof(tables[0]);
+
     try
     {
         /// Open database only for reading
@@ -310,52 +919,52 @@ CMake::LoadFromDatabase()
         if (!db.IsOpen())
             return false;
 
-        // Strings - Version
+        // Find installation
+        int installation;
         {
-            wxSQLite3ResultSet res = db.ExecuteQuery("SELECT desc FROM strings WHERE name = 'version'");
-            if (res.NextRow()) {
-                m_version = res.GetAsString(0);
-            }
-        }
+            wxSQLite3Statement stmt = db.PrepareStatement("SELECT id FROM installations WHERE path = ? AND version = ?");
+            stmt.Bind(1, GetPath().GetFullPath());
+            stmt.Bind(2, m_version);
 
-        // No data stored
-        if (m_version.IsEmpty())
-            return false;
+            wxSQLite3ResultSet res = stmt.ExecuteQuery();
 
-        // Commands
-        {
-            wxSQLite3ResultSet res = db.ExecuteQuery("SELECT name, desc FROM commands");
-            while (res.NextRow()) {
-                m_commands[res.GetAsString(0)] = res.GetAsString(1);
-            }
-        }
+            // No data stored
+            if (!res.NextRow())
+                return false;
 
-        // Modules
-        {
-            wxSQLite3ResultSet res = db.ExecuteQuery("SELECT name, desc FROM modules");
-            while (res.NextRow()) {
-                m_modules[res.GetAsString(0)] = res.GetAsString(1);
-            }
+            installation = res.GetInt(0);
         }
 
-        // Properties
-        {
-            wxSQLite3ResultSet res = db.ExecuteQuery("SELECT name, desc FROM properties");
+        // In lazy mode only names are loaded
+        const wxString columns = m_lazy ? "name" : "name, desc";
+
+        // Foreach tables
+        for (int i = 0; i < tablesCount; ++i) {
+            wxSQLite3Statement stmt = db.PrepareStatement("SELECT " + columns + " FROM " + tables[i].first + " WHERE installation = ?");
+            stmt.Bind(1, installation);
+
+            wxSQLite3ResultSet res = stmt.ExecuteQuery();
             while (res.NextRow()) {
-                m_properties[res.GetAsString(0)] = res.GetAsString(1);
+                (*tables[i].second)[res.GetAsString(0)] = m_lazy ? wxString() : res.GetAsString(1);
             }
         }
 
-        // Variables
-        {
-            wxSQLite3ResultSet res = db.ExecuteQuery("SELECT name, desc FROM variables");
-            while (res.NextRow()) {
-                m_variables[res.GetAsString(0)] = res.GetAsString(1);
+        m_installation = installation;
+
+        // Data stored without full-text index
+        if (m_ftsVersion) {
+            wxSQLite3Statement stmt = db.PrepareStatement("SELECT COUNT(*) FROM help_fts WHERE installation = ?");
+            stmt.Bind(1, installation);
+
+            if (!stmt.ExecuteScalar()) {
+                db.Begin();
+                IndexIntoDatabase(db);
+                db.Commit();
             }
         }
 
     } catch (const wxSQLite3Exception& e) {
-        CL_ERROR("Error occured while loading data from CMake database: %s", e.GetMessage());
+        CMAKE_ERROR("Error occured while loading data from CMake database: %s", e.GetMessage());
     }
 
     // Everything is loaded
@@ -364,14 +973,29 @@ CMake::LoadFromDatabase()
 
 /* ************************************************************************ */
 
-void
+bool
 CMake::StoreIntoDatabase()
 {
     if (!m_dbInitialized) {
-        CL_WARNING("CMake: can't store data into database. Database was not initialized properly");
-        return;
+        CMAKE_WARNING("CMake: can't store data into database. Database was not initialized properly");
+        return false;
+    }
+
+    // Data of unknown version would be matched by mistake later
+    if (m_version.IsEmpty()) {
+        CMAKE_WARNING("CMake: can't store data into database. Unknown cmake version");
+        return false;
     }
 
+    // Stored tables
+    const std::pair<wxString, const HelpMap*> tables[] = {
+        std::make_pair("commands", &m_commands),
+        std::make_pair("modules", &m_modules),
+        std::make_pair("properties", &m_properties),
+        std::make_pair("variables", &m_variables)
+    };
+    const int tablesCount = sizeof(tables) / sizeof(tables[0]);
+
     try
     {
         /// Open database only for writing
@@ -382,66 +1006,124 @@ CMake::StoreIntoDatabase()
 
         // Not opened
         if (!db.IsOpen())
-            return;
+            return false;
 
         db.Begin();
 
-        // Commands
+        // Installation
+        int installation;
         {
-            db.ExecuteUpdate("DELETE FROM commands");
-            wxSQLite3Statement stmt = db.PrepareStatement("INSERT INTO commands (name, desc) VALUES(?, ?)");
-            for (HelpMap::const_iterator it = m_commands.begin(), ite = m_commands.end(); it != ite; ++it) {
-                stmt.Bind(1, it->first);
-                stmt.Bind(2, it->second);
-                stmt.ExecuteUpdate();
-            }
-        }
+            wxSQLite3Statement stmt = db.PrepareStatement("INSERT OR IGNORE INTO installations (path, version) VALUES(?, ?)");
+            stmt.Bind(1, GetPath().GetFullPath());
+            stmt.Bind(2, m_version);
+            stmt.ExecuteUpdate();
 
-        // Modules
-        {
-            db.ExecuteUpdate("DELETE FROM modules");
-            wxSQLite3Statement stmt = db.PrepareStatement("INSERT INTO modules (name, desc) VALUES(?, ?)");
-            for (HelpMap::const_iterator it = m_modules.begin(), ite = m_modules.end(); it != ite; ++it) {
-                stmt.Bind(1, it->first);
-                stmt.Bind(2, it->second);
-                stmt.ExecuteUpdate();
-            }
+            wxSQLite3Statement query = db.PrepareStatement("SELECT id FROM installations WHERE path = ? AND version = ?");
+            query.Bind(1, GetPath().GetFullPath());
+            query.Bind(2, m_version);
+            installation = query.ExecuteScalar();
         }
 
-        // Properties
-        {
-            db.ExecuteUpdate("DELETE FROM properties");
-            wxSQLite3Statement stmt = db.PrepareStatement("INSERT INTO properties (name, desc) VALUES(?, ?)");
-            for (HelpMap::const_iterator it = m_properties.begin(), ite = m_properties.end(); it != ite; ++it) {
-                stmt.Bind(1, it->first);
-                stmt.Bind(2, it->second);
+        // Foreach tables, only data of the installation are replaced
+        for (int i = 0; i < tablesCount; ++i) {
+            wxSQLite3Statement del = db.PrepareStatement("DELETE FROM " + tables[i].first + " WHERE installation = ?");
+            del.Bind(1, installation);
+            del.ExecuteUpdate();
+
+            wxSQLite3Statement stmt = db.PrepareStatement("INSERT INTO " + tables[i].first + " (installation, name, desc) VALUES(?, ?, ?)");
+            for (HelpMap::const_iterator it = tables[i].second->begin(), ite = tables[i].second->end(); it != ite; ++it) {
+                stmt.Bind(1, installation);
+                stmt.Bind(2, it->first);
+                stmt.Bind(3, it->second);
                 stmt.ExecuteUpdate();
             }
         }
 
-        // Variables
-        {
-            db.ExecuteUpdate("DELETE FROM variables");
-            wxSQLite3Statement stmt = db.PrepareStatement("INSERT INTO variables (name, desc) VALUES(?, ?)");
-            for (HelpMap::const_iterator it = m_variables.begin(), ite = m_variables.end(); it != ite; ++it) {
-                stmt.Bind(1, it->first);
-                stmt.Bind(2, it->second);
-                stmt.ExecuteUpdate();
-            }
-        }
+        m_installation = installation;
 
-        // Strings - Version
-        {
-            wxSQLite3Statement stmt = db.PrepareStatement("REPLACE INTO strings (name, desc) VALUES('version', ?)");
-            stmt.Bind(1, m_version);
-            stmt.ExecuteUpdate();
-        }
+        // Update full-text index
+        IndexIntoDatabase(db);
 
         db.Commit();
 
     } catch (wxSQLite3Exception &e) {
-        CL_ERROR("An error occured while storing CMake data into database: %s", e.GetMessage());
+        CMAKE_ERROR("An error occured while storing CMake data into database: %s", e.GetMessage());
+        return false;
     }
+
+    return true;
+}
+
+/* ************************************************************************ */
+
+void
+CMake::IndexIntoDatabase(wxSQLite3Database& db)
+{
+    if (!m_ftsVersion || m_installation < 0)
+        return;
+
+    static const wxString tables[] = {
+        "commands",
+        "modules",
+        "properties",
+        "variables"
+    };
+    static const int tablesCount = sizeof(tables) / sizeof(tables[0]);
+
+    // Remove old index
+    {
+        wxSQLite3Statement stmt = db.PrepareStatement("DELETE FROM help_fts WHERE installation = ?");
+        stmt.Bind(1, m_installation);
+        stmt.ExecuteUpdate();
+    }
+
+    // Index text without HTML markup
+    for (int i = 0; i < tablesCount; ++i) {
+        wxSQLite3Statement stmt = db.PrepareStatement(
+            "INSERT INTO help_fts (installation, topic, name, desc) "
+            "SELECT installation, ?, name, "
+            "replace(replace(replace(desc, '<br />', ' '), '&lt;', '<'), '&gt;', '>') "
+            "FROM " + tables[i] + " WHERE installation = ?"
+        );
+        stmt.Bind(1, tables[i]);
+        stmt.Bind(2, m_installation);
+        stmt.ExecuteUpdate();
+    }
+}
+
+/* ************************************************************************ */
+
+wxString
+CMake::LoadPageFromDatabase(const wxString& table, const wxString& name) const
+{
+    if (!m_dbInitialized || m_installation < 0)
+        return wxEmptyString;
+
+    try
+    {
+        /// Open database only for reading
+        wxSQLite3Database db;
+
+        // Open
+        db.Open(GetDatabaseFileName().GetFullPath());
+
+        // Not opened
+        if (!db.IsOpen())
+            return wxEmptyString;
+
+        wxSQLite3Statement stmt = db.PrepareStatement("SELECT desc FROM " + table + " WHERE installation = ? AND name = ?");
+        stmt.Bind(1, m_installation);
+        stmt.Bind(2, name);
+
+        wxSQLite3ResultSet res = stmt.ExecuteQuery();
+        if (res.NextRow())
+            return res.GetAsString(0);
+
+    } catch (const wxSQLite3Exception& e) {
+        CMAKE_ERROR("Error occured while loading help page from CMake database: %s", e.GetMessage());
+    }
+
+    return wxEmptyString;
 }
 
 /* ************************************************************************ */
@@ -455,7 +1137,7 @@ CMake::LoadList(const wxString& type, CMake::HelpMap& list,
     // Get list
     wxArrayString names;
     const wxString cmdList = command + " --help-" + type + "-list";
-    ProcUtils::SafeExecuteCommand(cmdList, names);
+    CMakeCoreHost::Get().Execute(cmdList, names);
 
     // Remove version
     if (!names.IsEmpty())
@@ -464,6 +1146,13 @@ CMake::LoadList(const wxString& type, CMake::HelpMap& list,
     const int notifyCount = (names.GetCount() / limit) + 1;
     int loaded = 0;
 
+    // Load all pages at once, missing pages are loaded one by one
+    HelpMap bulk;
+    LoadListBulk(type, names, bulk);
+
+    // Items that are not part of the bulk output
+    wxArrayString missing;
+
     // Foreach names
     for (wxArrayString::const_iterator it = names.begin(), ite = names.end(); it != ite; ++it) {
 
@@ -471,21 +1160,16 @@ CMake::LoadList(const wxString& type, CMake::HelpMap& list,
         wxString name = *it;
         name.Trim().Trim(false);
 
-        // Export help
-        wxArrayString desc;
-        const wxString cmdItem = command + " --help-" + type + " \"" + name + "\"";
-        ProcUtils::SafeExecuteCommand(cmdItem, desc);
+        // Page already loaded
+        HelpMap::iterator page = bulk.find(name);
 
-        // Skip empty results
-        if (desc.IsEmpty())
+        if (page == bulk.end()) {
+            missing.Add(name);
             continue;
-
-        // Remove first line (cmake version)
-        if (desc.Item(0).Matches("*cmake version*"))
-            desc.RemoveAt(0);
+        }
 
         // Store help page
-        list[name] = CreateHtml(desc);
+        list[name] = page->second;
 
         // One more loaded
         loaded++;
@@ -496,6 +1180,124 @@ CMake::LoadList(const wxString& type, CMake::HelpMap& list,
             loaded = 0;
         }
     }
+
+    // Load the rest
+    if (!missing.IsEmpty())
+        LoadItems(type, missing, list, notifier, notifyCount, loaded);
+}
+
+/* ************************************************************************ */
+
+void
+CMake::LoadItems(const wxString& type, const wxArrayString& names,
+                 CMake::HelpMap& list, LoadNotifier* notifier,
+                 int notifyCount, int& loaded)
+{
+    LoadJobs jobs;
+    jobs.command = GetPath().GetFullPath();
+    jobs.type = type;
+    jobs.names = names;
+    jobs.pages.resize(names.GetCount());
+
+    // One worker per CPU, but each worker runs a whole cmake process
+    size_t count = std::min(std::max(wxThread::GetCPUCount(), 1), MAX_LOAD_WORKERS);
+    count = std::min(count, names.GetCount());
+
+    wxVector<LoadWorker*> workers;
+
+    // Start workers
+    for (size_t i = 0; i < count; ++i) {
+        LoadWorker* worker = new LoadWorker(jobs);
+
+        if (worker->Run() != wxTHREAD_NO_ERROR) {
+            CMAKE_ERROR("CMake: unable to run help loading worker");
+            delete worker;
+            break;
+        }
+
+        workers.push_back(worker);
+    }
+
+    // Unable to run any worker, load in the current thread
+    if (workers.empty()) {
+        LoadWorker worker(jobs);
+        worker.Process(notifier);
+    }
+
+    // Wait for workers and report progress
+    {
+        wxMutexLocker lock(jobs.mutex);
+        size_t reported = 0;
+
+        while (true) {
+            for (; reported < jobs.finished; ++reported) {
+                // One more loaded
+                loaded++;
+
+                // Add 1%
+                if (notifier && loaded == notifyCount) {
+                    notifier->Inc(1);
+                    loaded = 0;
+                }
+            }
+
+            // Everything is loaded or loading is stopped
+            if (jobs.stop || jobs.finished == jobs.names.GetCount())
+                break;
+
+            // Stop request, workers finish only running items
+            if (notifier && notifier->RequestStop()) {
+                jobs.stop = true;
+                break;
+            }
+
+            jobs.finishedCond.WaitTimeout(100);
+        }
+    }
+
+    // Join workers
+    for (wxVector<LoadWorker*>::iterator it = workers.begin(), ite = workers.end(); it != ite; ++it) {
+        (*it)->Wait();
+        delete *it;
+    }
+
+    // Store help pages in names order
+    for (size_t i = 0; i < jobs.names.GetCount(); ++i) {
+        if (!jobs.pages[i].IsEmpty())
+            list[jobs.names[i]] = jobs.pages[i];
+    }
+}
+
+/* ************************************************************************ */
+
+void
+CMake::LoadListBulk(const wxString& type, const wxArrayString& names,
+                    CMake::HelpMap& list)
+{
+    // Names lookup
+    std::set<wxString> lookup;
+
+    for (wxArrayString::const_iterator it = names.begin(), ite = names.end(); it != ite; ++it) {
+        wxString name = *it;
+        lookup.insert(name.Trim().Trim(false));
+    }
+
+    if (lookup.empty())
+        return;
+
+    // Get help pages of all items
+    wxArrayString lines;
+    const wxString cmdBulk = GetPath().GetFullPath() + " " + GetBulkOption(type);
+    CMakeCoreHost::Get().Execute(cmdBulk, lines);
+
+    // Split output into pages
+    std::map<wxString, wxArrayString> pages;
+    SplitHelp(lines, lookup, pages);
+
+    // Store help pages
+    for (std::map<wxString, wxArrayString>::const_iterator it = pages.begin(), ite = pages.end(); it != ite; ++it) {
+        list[it->first] = CreateHtml(it->second);
+    }
 }
 
 /* ************************************************************************ */
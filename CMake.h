@@ -27,13 +27,14 @@
 
 // C++
 #include <map>
+#include <list>
+#include <utility>
 
 // wxWidgets
 #include <wx/string.h>
 #include <wx/filename.h>
 #include <wx/arrstr.h>
 #include <wx/vector.h>
-#include <wx/progdlg.h>
 #include <wx/wxsqlite3.h>
 
 /* ************************************************************************ */
@@ -105,6 +106,25 @@ public:
     /// Lines map.
     typedef std::map<wxString, wxString> HelpMap;
 
+    /// Cached help pages (most recently used first).
+    typedef std::list<std::pair<wxString, wxString> > PageCache;
+
+
+    /**
+     * @brief Full-text search hit.
+     */
+    struct SearchHit
+    {
+        /// List that contains the item.
+        const HelpMap* list;
+
+        /// Item name.
+        wxString name;
+    };
+
+    /// Search result.
+    typedef wxVector<SearchHit> SearchResult;
+
 
 // Public Ctors
 public:
@@ -155,10 +175,10 @@ public:
     /**
      * @brief Returns CMake version.
      *
-     * @return
+     * @return Version or "?" if version is unknown.
      */
-    const wxString& GetVersion() const {
-        return m_version;
+    wxString GetVersion() const {
+        return m_version.IsEmpty() ? wxString("?") : m_version;
     }
 
 
@@ -212,6 +232,19 @@ public:
     }
 
 
+    /**
+     * @brief Returns if help pages are loaded on demand.
+     *
+     * In lazy mode lists contains only item names and help pages
+     * must be obtained by GetHelp().
+     *
+     * @return
+     */
+    bool IsLazy() const {
+        return m_lazy;
+    }
+
+
 // Public Mutators
 public:
 
@@ -226,6 +259,16 @@ public:
     }
 
 
+    /**
+     * @brief Changes lazy mode. Change takes effect on next load.
+     *
+     * @param lazy
+     */
+    void SetLazy(bool lazy) {
+        m_lazy = lazy;
+    }
+
+
 // Public Operations
 public:
 
@@ -242,12 +285,80 @@ public:
     bool LoadData(bool force = false, LoadNotifier* notifier = NULL);
 
 
+    /**
+     * @brief Returns help page of the item.
+     *
+     * If page is not stored in the list (lazy mode) it's loaded from
+     * the database and kept in a small cache of recently used pages.
+     * Page which is not in the database is not produced by cmake here,
+     * use LoadHelp() (e.g. from a thread) and AddHelp().
+     *
+     * @param list List that contains the item (e.g. GetCommands()).
+     * @param name Item name.
+     *
+     * @return Help page or empty string.
+     */
+    wxString GetHelp(const HelpMap& list, const wxString& name);
+
+
+    /**
+     * @brief Produces help page of the item by cmake application.
+     *
+     * It doesn't change any data so it can be called from a worker
+     * thread while the lists are not reloaded.
+     *
+     * @param list List that contains the item (e.g. GetCommands()).
+     * @param name Item name.
+     *
+     * @return Help page or empty string.
+     */
+    wxString LoadHelp(const HelpMap& list, const wxString& name) const;
+
+
+    /**
+     * @brief Stores help page into the cache of recently used pages.
+     *
+     * @param list List that contains the item.
+     * @param name Item name.
+     * @param page Help page (e.g. from LoadHelp()).
+     */
+    void AddHelp(const HelpMap& list, const wxString& name, const wxString& page);
+
+
+    /**
+     * @brief Searches text of help pages.
+     *
+     * Index is stored in the database and it's updated when the data
+     * are stored into the database. Hits are ordered by relevance
+     * if SQLite supports FTS5, otherwise by name.
+     *
+     * @param text  Searched words, the last one can be a prefix.
+     * @param list  Search only in this list or in all lists if NULL.
+     * @param limit Maximum number of hits.
+     *
+     * @return Search hits.
+     */
+    SearchResult Search(const wxString& text, const HelpMap* list = NULL,
+                        int limit = 100) const;
+
+
 // Private Operations
 private:
 
 
+    /**
+     * @brief Returns version reported by the cmake application.
+     *
+     * @return Version or empty string if cmake cannot be executed.
+     */
+    wxString LoadVersion() const;
+
+
     /**
      * @brief Prepare database for CMake.
+     *
+     * The database can hold data of several cmake installations, each
+     * one is identified by path to cmake and its version.
      */
     void PrepareDatabase();
 
@@ -265,6 +376,9 @@ private:
     /**
      * @brief Loads data from SQLite3 database.
      *
+     * Only data of the current installation (path and version)
+     * are loaded.
+     *
      * @return If data is loaded.
      */
     bool LoadFromDatabase();
@@ -272,8 +386,43 @@ private:
 
     /**
      * @brief Stores data into SQLite3 database.
+     *
+     * Data of other installations are kept.
+     *
+     * @return If data was stored.
+     */
+    bool StoreIntoDatabase();
+
+
+    /**
+     * @brief Loads help page of single item from SQLite3 database.
+     *
+     * @param table Table name.
+     * @param name  Item name.
+     *
+     * @return Help page or empty string.
+     */
+    wxString LoadPageFromDatabase(const wxString& table, const wxString& name) const;
+
+
+    /**
+     * @brief Fills full-text index of the current installation.
+     *
+     * @param db Opened database.
      */
-    void StoreIntoDatabase();
+    void IndexIntoDatabase(wxSQLite3Database& db);
+
+
+    /**
+     * @brief Finds database table and help type of the list.
+     *
+     * @param list  One of the help lists.
+     * @param table Output table name.
+     * @param type  Output help type.
+     *
+     * @return If list is known.
+     */
+    bool GetListInfo(const HelpMap& list, wxString& table, wxString& type) const;
 
 
     /**
@@ -288,6 +437,39 @@ private:
                   LoadNotifier* notifier, int limit);
 
 
+    /**
+     * @brief Loads help pages of all items of given type by single
+     * cmake call.
+     *
+     * Only items from the names list are stored into the output. Items
+     * that cannot be found in the cmake output are not stored and must
+     * be loaded by other way.
+     *
+     * @param type  Help type.
+     * @param names List of item names.
+     * @param list  Output variable.
+     */
+    void LoadListBulk(const wxString& type, const wxArrayString& names,
+                      CMake::HelpMap& list);
+
+
+    /**
+     * @brief Loads help pages of given items one by one.
+     *
+     * Items are loaded by a pool of worker threads.
+     *
+     * @param type        Help type.
+     * @param names       List of item names.
+     * @param list        Output variable.
+     * @param notifier    Progress notifier.
+     * @param notifyCount Number of items per one percent.
+     * @param loaded      Number of items loaded since the last notification.
+     */
+    void LoadItems(const wxString& type, const wxArrayString& names,
+                   CMake::HelpMap& list, LoadNotifier* notifier,
+                   int notifyCount, int& loaded);
+
+
 // Private Data Members
 private:
 
@@ -295,9 +477,12 @@ private:
     /// CMake application path.
     wxFileName m_path;
 
-    /// Cached CMake version.
+    /// Cached CMake version (empty if unknown).
     wxString m_version;
 
+    /// Path of cmake application the version belongs to.
+    wxString m_versionPath;
+
     /// List of commands.
     HelpMap m_commands;
 
@@ -316,6 +501,18 @@ private:
     /// Was the database initialized properly?
     bool m_dbInitialized;
 
+    /// Database ID of the current installation.
+    int m_installation;
+
+    /// Version of available SQLite full-text module (0, 4 or 5).
+    int m_ftsVersion;
+
+    /// If help pages are loaded on demand.
+    bool m_lazy;
+
+    /// Recently used help pages (lazy mode).
+    PageCache m_pageCache;
+
 };
 
 /* ************************************************************************ */
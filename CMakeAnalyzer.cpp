@@ -0,0 +1,548 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// Declaration
+#include "CMakeAnalyzer.h"
+
+// C++
+#include <algorithm>
+
+// CMakePlugin
+#include "CMakeCoreHost.h"
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Removes quotes around the argument.
+ *
+ * @param value Argument.
+ *
+ * @return
+ */
+static wxString Unquote(const wxString& value)
+{
+    if (value.length() >= 2 && value.StartsWith("\"") && value.EndsWith("\""))
+        return value.Mid(1, value.length() - 2);
+
+    return value;
+}
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Worker thread that parses files from the analyzer queue.
+ */
+class AnalyzeWorker : public wxThread
+{
+public:
+
+
+    /**
+     * @brief Constructor.
+     *
+     * @param analyzer Analyzer.
+     */
+    explicit AnalyzeWorker(CMakeAnalyzer& analyzer)
+        : wxThread(wxTHREAD_JOINABLE)
+        , m_analyzer(analyzer)
+    {}
+
+
+protected:
+
+
+    /**
+     * @brief Thread entry.
+     *
+     * @return Exit code.
+     */
+    virtual ExitCode Entry()
+    {
+        m_analyzer.Process();
+        return static_cast<ExitCode>(0);
+    }
+
+
+private:
+
+    /// Analyzer.
+    CMakeAnalyzer& m_analyzer;
+};
+
+/* ************************************************************************ */
+
+CMakeAnalyzer::CMakeAnalyzer()
+    : m_cache(NULL)
+    , m_stopRequest(NULL)
+    , m_stopped(false)
+    , m_cond(m_mutex)
+    , m_next(0)
+    , m_active(0)
+{
+    // Nothing to do
+}
+
+/* ************************************************************************ */
+
+CMakeAnalyzer::~CMakeAnalyzer()
+{
+    Clear();
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeAnalyzer::FindFile(const wxFileName& path, size_t& index) const
+{
+    wxFileName fullPath(path);
+    fullPath.MakeAbsolute();
+
+    std::map<wxString, size_t>::const_iterator it = m_paths.find(fullPath.GetFullPath());
+
+    if (it == m_paths.end())
+        return false;
+
+    index = it->second;
+    return true;
+}
+
+/* ************************************************************************ */
+
+void
+CMakeAnalyzer::Clear()
+{
+    for (wxVector<File*>::iterator it = m_files.begin(), ite = m_files.end(); it != ite; ++it) {
+        delete *it;
+    }
+
+    m_rootDir.clear();
+    m_files.clear();
+    m_paths.clear();
+    m_variables.clear();
+    m_next = 0;
+    m_active = 0;
+    m_stopped = false;
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeAnalyzer::Analyze(const wxFileName& root)
+{
+    Clear();
+
+    wxFileName path(root);
+    path.MakeAbsolute();
+
+    m_rootDir = path.GetPath();
+
+    // Root file is the first in the queue
+    AddFile(path.GetFullPath(), m_rootDir, 0);
+
+    std::set<size_t> visited;
+
+    // Parse the queue and resolve modules until no new module is found
+    do {
+        RunWorkers();
+        visited.clear();
+
+        // Graph is incomplete
+        if (m_stopped)
+            return false;
+
+    } while (Resolve(visited) > 0);
+
+    // Collect variables from files reachable from the root
+    for (std::set<size_t>::const_iterator it = visited.begin(), ite = visited.end(); it != ite; ++it) {
+        const wxVector<CMakeSymbols::Id>& variables = m_files[*it]->parser.GetVariables();
+
+        for (wxVector<CMakeSymbols::Id>::const_iterator itv = variables.begin(),
+            itve = variables.end(); itv != itve; ++itv) {
+            m_variables[*itv].push_back(*it);
+        }
+    }
+
+    return m_files[0]->parsed;
+}
+
+/* ************************************************************************ */
+
+void
+CMakeAnalyzer::RunWorkers()
+{
+    // One worker per CPU
+    const size_t count = std::max(wxThread::GetCPUCount(), 1);
+
+    wxVector<AnalyzeWorker*> workers;
+
+    // Start workers
+    for (size_t i = 0; i < count; ++i) {
+        AnalyzeWorker* worker = new AnalyzeWorker(*this);
+
+        if (worker->Run() != wxTHREAD_NO_ERROR) {
+            CMAKE_ERROR("CMake: unable to run analyzer worker");
+            delete worker;
+            break;
+        }
+
+        workers.push_back(worker);
+    }
+
+    // Unable to run any worker, parse in the current thread
+    if (workers.empty())
+        Process();
+
+    // Join workers
+    for (wxVector<AnalyzeWorker*>::iterator it = workers.begin(), ite = workers.end(); it != ite; ++it) {
+        (*it)->Wait();
+        delete *it;
+    }
+}
+
+/* ************************************************************************ */
+
+void
+CMakeAnalyzer::Process()
+{
+    while (true) {
+        size_t index;
+        File* file;
+
+        // Take next file
+        {
+            wxMutexLocker lock(m_mutex);
+
+            // Queue is empty but running workers can add more files
+            while (!m_stopped && m_next >= m_files.size() && m_active > 0)
+                m_cond.Wait();
+
+            // Wake up waiting workers, they stop too
+            if (!m_stopped && m_stopRequest && m_stopRequest->RequestStop()) {
+                m_stopped = true;
+                m_cond.Broadcast();
+            }
+
+            // Everything is parsed or analysis is stopped
+            if (m_stopped || m_next >= m_files.size())
+                break;
+
+            index = m_next++;
+            file = m_files[index];
+            m_active++;
+        }
+
+        ParseFile(index, *file);
+
+        // Wake up waiting workers
+        {
+            wxMutexLocker lock(m_mutex);
+            m_active--;
+            m_cond.Broadcast();
+        }
+    }
+}
+
+/* ************************************************************************ */
+
+size_t
+CMakeAnalyzer::AddFile(const wxString& path, const wxString& sourceDir,
+                       size_t parent)
+{
+    std::map<wxString, size_t>::const_iterator it = m_paths.find(path);
+
+    // Already known
+    if (it != m_paths.end())
+        return it->second;
+
+    File* file = new File;
+    file->path = path;
+    file->sourceDir = sourceDir;
+    file->parent = parent;
+    file->parsed = false;
+
+    const size_t index = m_files.size();
+    m_files.push_back(file);
+    m_paths[path] = index;
+
+    return index;
+}
+
+/* ************************************************************************ */
+
+void
+CMakeAnalyzer::ParseFile(size_t index, File& file)
+{
+    file.parsed = file.parser.ParseFile(wxFileName(file.path), m_cache);
+
+    if (!file.parsed) {
+        CMAKE_WARNING("CMake: unable to parse '%s'", file.path);
+        return;
+    }
+
+    // Files referenced by path with their source directories
+    wxArrayString paths;
+    wxArrayString sourceDirs;
+
+    const CMakeParser& parser = file.parser;
+    const wxVector<CMakeParser::Command>& commands = parser.GetCommands();
+
+    for (size_t i = 0; i < commands.size(); ++i) {
+        const CMakeParser::Command& command = commands[i];
+
+        if (!command.argumentCount)
+            continue;
+
+        const CMakeSymbols::Id name = command.name;
+
+        // Only these commands are interesting
+        if (name != CMakeSymbols::AddSubdirectory && name != CMakeSymbols::Include &&
+            name != CMakeSymbols::FindPackage && name != CMakeSymbols::Set &&
+            name != CMakeSymbols::List) {
+            continue;
+        }
+
+        const wxString arg = Expand(file, parser.GetArgument(command, 0));
+
+        Reference item;
+        item.type = ReferenceFile;
+        item.link = LinkInclude;
+        item.command = i;
+
+        if (name == CMakeSymbols::AddSubdirectory) {
+
+            if (arg.IsEmpty())
+                continue;
+
+            wxFileName path(arg, "");
+            path.MakeAbsolute(file.sourceDir);
+            path.SetFullName("CMakeLists.txt");
+
+            if (!path.FileExists())
+                continue;
+
+            // Subdirectory has its own source directory
+            item.link = LinkSubdirectory;
+            item.value = path.GetFullPath();
+            sourceDirs.Add(path.GetPath());
+
+        } else if (name == CMakeSymbols::Include) {
+
+            if (arg.IsEmpty())
+                continue;
+
+            // Module name or path to file
+            if (arg.Find('/') == wxNOT_FOUND && !arg.EndsWith(".cmake")) {
+                item.type = ReferenceModule;
+                item.value = arg + ".cmake";
+            } else {
+                wxFileName path(arg);
+                path.MakeAbsolute(file.sourceDir);
+
+                if (!path.FileExists())
+                    continue;
+
+                item.value = path.GetFullPath();
+                sourceDirs.Add(file.sourceDir);
+            }
+
+        } else if (name == CMakeSymbols::FindPackage) {
+
+            if (arg.IsEmpty())
+                continue;
+
+            // Only module mode packages can be found
+            item.type = ReferenceModule;
+            item.link = LinkPackage;
+            item.value = "Find" + arg + ".cmake";
+
+        } else {
+
+            size_t first = 1;
+
+            // list(APPEND CMAKE_MODULE_PATH ...)
+            if (name == CMakeSymbols::List) {
+                if (arg != "APPEND" || command.argumentCount < 2)
+                    continue;
+
+                if (parser.GetArgument(command, 1) != "CMAKE_MODULE_PATH")
+                    continue;
+
+                first = 2;
+
+            } else if (arg != "CMAKE_MODULE_PATH") {
+                continue;
+            }
+
+            item.type = ReferenceModulePath;
+
+            for (size_t j = first; j < command.argumentCount; ++j) {
+                const wxString value = Expand(file, parser.GetArgument(command, j));
+
+                if (value.IsEmpty())
+                    continue;
+
+                wxFileName path(value, "");
+                path.MakeAbsolute(file.sourceDir);
+                item.value = path.GetPath();
+                file.references.push_back(item);
+            }
+
+            continue;
+        }
+
+        if (item.type == ReferenceFile)
+            paths.Add(item.value);
+
+        file.references.push_back(item);
+    }
+
+    // Everything needed is extracted, don't keep the file mapped, it would
+    // block replacing it on Windows and truncating it would crash us
+    file.parser.ReleaseSource();
+
+    if (paths.IsEmpty())
+        return;
+
+    // Add files referenced by path into the queue, modules must wait
+    // for the graph walk
+    wxMutexLocker lock(m_mutex);
+
+    for (size_t i = 0; i < paths.GetCount(); ++i)
+        AddFile(paths[i], sourceDirs[i], index);
+}
+
+/* ************************************************************************ */
+
+size_t
+CMakeAnalyzer::Resolve(std::set<size_t>& visited)
+{
+    const size_t count = m_files.size();
+
+    wxArrayString paths = m_modulePaths;
+    ResolveFile(0, paths, visited);
+
+    return m_files.size() - count;
+}
+
+/* ************************************************************************ */
+
+void
+CMakeAnalyzer::ResolveFile(size_t index, wxArrayString& paths,
+                           std::set<size_t>& visited)
+{
+    // Each file is walked only once, from the first place it's referenced
+    if (!visited.insert(index).second)
+        return;
+
+    File& file = *m_files[index];
+    file.links.clear();
+
+    for (wxVector<Reference>::const_iterator it = file.references.begin(),
+        ite = file.references.end(); it != ite; ++it) {
+
+        Link link;
+        link.type = it->link;
+        link.command = it->command;
+
+        if (it->type == ReferenceModulePath) {
+            if (paths.Index(it->value) == wxNOT_FOUND)
+                paths.Add(it->value);
+
+            continue;
+
+        } else if (it->type == ReferenceModule) {
+            const wxString path = FindModule(paths, it->value);
+
+            if (path.IsEmpty())
+                continue;
+
+            // Found module is parsed in the next round
+            link.file = AddFile(path, file.sourceDir, index);
+
+        } else {
+            std::map<wxString, size_t>::const_iterator itp = m_paths.find(it->value);
+            wxASSERT(itp != m_paths.end());
+            link.file = itp->second;
+        }
+
+        file.links.push_back(link);
+
+        // Not parsed yet
+        if (link.file >= m_next)
+            continue;
+
+        if (link.type == LinkSubdirectory) {
+            // Subdirectory has its own scope
+            wxArrayString scope(paths);
+            ResolveFile(link.file, scope, visited);
+        } else {
+            ResolveFile(link.file, paths, visited);
+        }
+    }
+}
+
+/* ************************************************************************ */
+
+wxString
+CMakeAnalyzer::Expand(const File& file, const wxString& value) const
+{
+    wxString result = Unquote(value);
+
+    // Nothing to expand
+    if (result.Find('$') == wxNOT_FOUND)
+        return result;
+
+    result.Replace("${CMAKE_CURRENT_SOURCE_DIR}", file.sourceDir);
+    result.Replace("${CMAKE_CURRENT_LIST_DIR}", wxFileName(file.path).GetPath());
+    result.Replace("${CMAKE_SOURCE_DIR}", m_rootDir);
+    result.Replace("${PROJECT_SOURCE_DIR}", m_rootDir);
+
+    // Unknown variable
+    if (result.Find('$') != wxNOT_FOUND)
+        return wxEmptyString;
+
+    return result;
+}
+
+/* ************************************************************************ */
+
+wxString
+CMakeAnalyzer::FindModule(const wxArrayString& paths, const wxString& name)
+{
+    for (size_t i = 0; i < paths.GetCount(); ++i) {
+        wxFileName path(paths[i], name);
+
+        if (path.FileExists())
+            return path.GetFullPath();
+    }
+
+    return wxEmptyString;
+}
+
+/* ************************************************************************ */
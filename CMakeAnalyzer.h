@@ -0,0 +1,475 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+#ifndef CMAKE_ANALYZER_H_
+#define CMAKE_ANALYZER_H_
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// C++
+#include <map>
+#include <set>
+
+// wxWidgets
+#include <wx/string.h>
+#include <wx/arrstr.h>
+#include <wx/vector.h>
+#include <wx/filename.h>
+#include <wx/thread.h>
+
+// CMakePlugin
+#include "CMakeParser.h"
+#include "CMakeParseCache.h"
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Project-level analyzer of CMake files.
+ *
+ * Analyzer starts from the root CMakeLists.txt and follows
+ * add_subdirectory(), include() and find_package() commands to build
+ * a graph of parsed files. Files are parsed in parallel by a pool
+ * of worker threads as soon as they are discovered.
+ *
+ * Only references that can be resolved statically are followed:
+ * arguments can use ${CMAKE_CURRENT_SOURCE_DIR}, ${CMAKE_CURRENT_LIST_DIR},
+ * ${CMAKE_SOURCE_DIR} and ${PROJECT_SOURCE_DIR}. Modules are searched in
+ * given module paths and in paths added to CMAKE_MODULE_PATH.
+ *
+ * Modules are resolved after parsing by walking the graph in source order
+ * as CMake does, so the result doesn't depend on the order in which
+ * the workers parse files. Paths added in a subdirectory are visible
+ * only in that subdirectory, paths added in an included file are visible
+ * to the includer.
+ */
+class CMakeAnalyzer
+{
+
+// Public Enums
+public:
+
+
+    /**
+     * @brief Type of link between files.
+     */
+    enum LinkType
+    {
+        /// add_subdirectory()
+        LinkSubdirectory = 0,
+
+        /// include()
+        LinkInclude,
+
+        /// find_package()
+        LinkPackage
+    };
+
+
+    /**
+     * @brief Type of reference found in a file.
+     */
+    enum ReferenceType
+    {
+        /// Full path to a file.
+        ReferenceFile = 0,
+
+        /// Module file name searched in module paths.
+        ReferenceModule,
+
+        /// Path added to CMAKE_MODULE_PATH.
+        ReferenceModulePath
+    };
+
+
+// Public Structures
+public:
+
+
+    /**
+     * @brief Link from a command to a file.
+     */
+    struct Link
+    {
+        /// Link type.
+        LinkType type;
+
+        /// Index of the command in the source file.
+        size_t command;
+
+        /// Index of the target file.
+        size_t file;
+    };
+
+
+    /**
+     * @brief Reference from a command to a file or module path.
+     */
+    struct Reference
+    {
+        /// Reference type.
+        ReferenceType type;
+
+        /// Link type (ReferenceFile and ReferenceModule).
+        LinkType link;
+
+        /// Index of the command in the source file.
+        size_t command;
+
+        /// Full path, module file name or module path.
+        wxString value;
+    };
+
+
+    /**
+     * @brief Parsed file.
+     */
+    struct File
+    {
+        /// Full path to the file.
+        wxString path;
+
+        /// Value of CMAKE_CURRENT_SOURCE_DIR for the file.
+        wxString sourceDir;
+
+        /// Index of the file which references this file (root references itself).
+        size_t parent;
+
+        /// If file was parsed.
+        bool parsed;
+
+        /// File parser (its source is released after parsing).
+        CMakeParser parser;
+
+        /// References in source order.
+        wxVector<Reference> references;
+
+        /// Links to other files.
+        wxVector<Link> links;
+    };
+
+
+    /**
+     * @brief Helper class that tells the analyzer to stop.
+     */
+    class StopRequest
+    {
+    public:
+
+        /**
+         * @brief Checks if analysis should be stopped.
+         *
+         * Called by worker threads before each file is parsed.
+         *
+         * @return
+         */
+        virtual bool RequestStop() const = 0;
+
+    };
+
+
+// Public Types
+public:
+
+
+    /// Map of variable symbol to the list of files that define it.
+    typedef std::map<CMakeSymbols::Id, wxVector<size_t> > VariableMap;
+
+
+// Public Ctors & Dtors
+public:
+
+
+    /**
+     * @brief Constructor.
+     */
+    CMakeAnalyzer();
+
+
+    /**
+     * @brief Destructor.
+     */
+    ~CMakeAnalyzer();
+
+
+// Public Accessors
+public:
+
+
+    /**
+     * @brief Returns number of files in the graph.
+     *
+     * @return
+     */
+    size_t GetFileCount() const {
+        return m_files.size();
+    }
+
+
+    /**
+     * @brief Returns file from the graph. Root file has index 0.
+     *
+     * @param index File index.
+     *
+     * @return
+     */
+    const File& GetFile(size_t index) const {
+        return *m_files[index];
+    }
+
+
+    /**
+     * @brief Finds file by its path.
+     *
+     * @param path Path to file.
+     * @param index Output file index.
+     *
+     * @return If file is in the graph.
+     */
+    bool FindFile(const wxFileName& path, size_t& index) const;
+
+
+    /**
+     * @brief Returns variables defined in all parsed files.
+     *
+     * @return
+     */
+    const VariableMap& GetVariables() const {
+        return m_variables;
+    }
+
+
+    /**
+     * @brief Returns module search paths.
+     *
+     * @return
+     */
+    const wxArrayString& GetModulePaths() const {
+        return m_modulePaths;
+    }
+
+
+// Public Mutators
+public:
+
+
+    /**
+     * @brief Changes additional module search paths.
+     *
+     * @param paths
+     */
+    void SetModulePaths(const wxArrayString& paths) {
+        m_modulePaths = paths;
+    }
+
+
+    /**
+     * @brief Changes cache of parsed files.
+     *
+     * @param cache Cache or NULL.
+     */
+    void SetCache(CMakeParseCache* cache) {
+        m_cache = cache;
+    }
+
+
+    /**
+     * @brief Changes object that can stop the analysis.
+     *
+     * @param request Stop request or NULL.
+     */
+    void SetStopRequest(const StopRequest* request) {
+        m_stopRequest = request;
+    }
+
+
+// Public Operations
+public:
+
+
+    /**
+     * @brief Removes all files from the graph.
+     */
+    void Clear();
+
+
+    /**
+     * @brief Builds graph of files from given root CMakeLists.txt.
+     *
+     * @param root Path to the root CMakeLists.txt.
+     *
+     * @return If root file was parsed and the analysis wasn't stopped.
+     */
+    bool Analyze(const wxFileName& root);
+
+
+    /**
+     * @brief Parses files from the queue until the queue is empty
+     * or the analysis is stopped.
+     *
+     * Called by worker threads.
+     */
+    void Process();
+
+
+// Private Operations
+private:
+
+
+    /**
+     * @brief Adds file into the graph if it isn't there already.
+     *
+     * Must be called with locked mutex.
+     *
+     * @param path      Normalized full path.
+     * @param sourceDir CMAKE_CURRENT_SOURCE_DIR for the file.
+     * @param parent    Index of the referencing file.
+     *
+     * @return File index.
+     */
+    size_t AddFile(const wxString& path, const wxString& sourceDir,
+                   size_t parent);
+
+
+    /**
+     * @brief Parses the file and adds referenced files into the queue.
+     *
+     * Modules cannot be found until the graph is walked so they are
+     * only stored as references.
+     *
+     * @param index File index.
+     * @param file  Parsed file.
+     */
+    void ParseFile(size_t index, File& file);
+
+
+    /**
+     * @brief Runs workers until the parsing queue is empty.
+     */
+    void RunWorkers();
+
+
+    /**
+     * @brief Walks the graph from the root file in source order and
+     * builds links. Found modules that aren't in the graph are added
+     * into the parsing queue.
+     *
+     * Must be called when no worker is running.
+     *
+     * @param visited Output set of files reachable from the root.
+     *
+     * @return Number of files added into the queue.
+     */
+    size_t Resolve(std::set<size_t>& visited);
+
+
+    /**
+     * @brief Resolves references of the file and walks linked files.
+     *
+     * @param index   File index.
+     * @param paths   Module search paths in the current scope.
+     * @param visited Set of already walked files.
+     */
+    void ResolveFile(size_t index, wxArrayString& paths,
+                     std::set<size_t>& visited);
+
+
+    /**
+     * @brief Expands known variables in the argument.
+     *
+     * @param file  File that contains the argument.
+     * @param value Argument.
+     *
+     * @return Expanded value or empty string if it cannot be expanded.
+     */
+    wxString Expand(const File& file, const wxString& value) const;
+
+
+    /**
+     * @brief Finds module in module search paths.
+     *
+     * @param paths Module search paths.
+     * @param name  Module file name.
+     *
+     * @return Full path or empty string.
+     */
+    static wxString FindModule(const wxArrayString& paths, const wxString& name);
+
+
+// Private Ctors
+private:
+
+
+    /// Not copyable.
+    CMakeAnalyzer(const CMakeAnalyzer&);
+
+    /// Not copyable.
+    CMakeAnalyzer& operator=(const CMakeAnalyzer&);
+
+
+// Private Data Members
+private:
+
+
+    /// Root source directory.
+    wxString m_rootDir;
+
+    /// Files in discovery order (it's also the parsing queue).
+    wxVector<File*> m_files;
+
+    /// Map of file path to file index.
+    std::map<wxString, size_t> m_paths;
+
+    /// Additional module search paths.
+    wxArrayString m_modulePaths;
+
+    /// Defined variables.
+    VariableMap m_variables;
+
+    /// Optional cache of parsed files.
+    CMakeParseCache* m_cache;
+
+    /// Optional stop request.
+    const StopRequest* m_stopRequest;
+
+    /// If the analysis was stopped.
+    bool m_stopped;
+
+    /// Guards files and paths during analysis.
+    wxMutex m_mutex;
+
+    /// Signaled when a file is parsed.
+    wxCondition m_cond;
+
+    /// Index of the next file to parse.
+    size_t m_next;
+
+    /// Number of files being parsed.
+    size_t m_active;
+
+};
+
+/* ************************************************************************ */
+
+#endif // CMAKE_ANALYZER_H_
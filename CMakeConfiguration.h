@@ -90,6 +90,16 @@ public:
     }
 
 
+    /**
+     * @brief Returns if CMake help pages are loaded on demand.
+     *
+     * @return
+     */
+    bool IsHelpLazy() const {
+        return ReadBool("LazyHelp", true);
+    }
+
+
 // Public Mutators
 public:
 
@@ -113,6 +123,16 @@ public:
         Write("Generator", generator);
     }
 
+
+    /**
+     * @brief Change if CMake help pages are loaded on demand.
+     *
+     * @param lazy
+     */
+    void SetHelpLazy(bool lazy) {
+        Write("LazyHelp", lazy);
+    }
+
 };
 
 /* ************************************************************************ */
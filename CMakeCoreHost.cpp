@@ -0,0 +1,153 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// Declaration
+#include "CMakeCoreHost.h"
+
+// C++
+#include <cstdio>
+#include <string>
+
+// wxWidgets
+#include <wx/log.h>
+
+/* ************************************************************************ */
+/* DEFINITIONS                                                              */
+/* ************************************************************************ */
+
+#ifdef __WXMSW__
+#define popen _popen
+#define pclose _pclose
+#endif
+
+/* ************************************************************************ */
+/* VARIABLES                                                                */
+/* ************************************************************************ */
+
+/// Default host.
+static CMakeCoreHost g_defaultHost;
+
+/// Installed host.
+static CMakeCoreHost* g_host = NULL;
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Converts command output line into string.
+ *
+ * @param line Line without line end.
+ *
+ * @return
+ */
+static wxString ToString(const std::string& line)
+{
+    const wxString result = wxString::FromUTF8(line.c_str(), line.size());
+
+    // Not an UTF-8
+    if (result.IsEmpty() && !line.empty())
+        return wxString::From8BitData(line.c_str(), line.size());
+
+    return result;
+}
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+void
+CMakeCoreHost::Log(LogLevel level, const wxString& message)
+{
+    switch (level)
+    {
+    case LOG_ERROR:
+        wxLogError("%s", message);
+        break;
+
+    case LOG_WARNING:
+        wxLogWarning("%s", message);
+        break;
+
+    case LOG_DEBUG:
+        wxLogDebug("%s", message);
+        break;
+    }
+}
+
+/* ************************************************************************ */
+
+void
+CMakeCoreHost::Execute(const wxString& command, wxArrayString& output)
+{
+    FILE* pipe = popen(command.mb_str(wxConvUTF8), "r");
+
+    if (!pipe)
+        return;
+
+    std::string line;
+    char buffer[4096];
+
+    while (fgets(buffer, sizeof(buffer), pipe))
+    {
+        line += buffer;
+
+        // Line continues in the next chunk
+        if (line.empty() || line[line.size() - 1] != '\n')
+            continue;
+
+        line.erase(line.size() - 1);
+
+        if (!line.empty() && line[line.size() - 1] == '\r')
+            line.erase(line.size() - 1);
+
+        output.Add(ToString(line));
+        line.clear();
+    }
+
+    // Last line without line end
+    if (!line.empty())
+        output.Add(ToString(line));
+
+    pclose(pipe);
+}
+
+/* ************************************************************************ */
+
+CMakeCoreHost&
+CMakeCoreHost::Get()
+{
+    return g_host ? *g_host : g_defaultHost;
+}
+
+/* ************************************************************************ */
+
+void
+CMakeCoreHost::Set(CMakeCoreHost* host)
+{
+    g_host = host;
+}
+
+/* ************************************************************************ */
@@ -0,0 +1,140 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+#ifndef CMAKE_CORE_HOST_H_
+#define CMAKE_CORE_HOST_H_
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// wxWidgets
+#include <wx/string.h>
+#include <wx/arrstr.h>
+
+/* ************************************************************************ */
+/* DEFINITIONS                                                              */
+/* ************************************************************************ */
+
+/// Logs an error message through the core host.
+#define CMAKE_ERROR(...) \
+    CMakeCoreHost::Get().Log(CMakeCoreHost::LOG_ERROR, wxString::Format(__VA_ARGS__))
+
+/// Logs a warning message through the core host.
+#define CMAKE_WARNING(...) \
+    CMakeCoreHost::Get().Log(CMakeCoreHost::LOG_WARNING, wxString::Format(__VA_ARGS__))
+
+/// Logs a debug message through the core host.
+#define CMAKE_DEBUG(...) \
+    CMakeCoreHost::Get().Log(CMakeCoreHost::LOG_DEBUG, wxString::Format(__VA_ARGS__))
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Services the core library requires from its environment.
+ *
+ * Core doesn't depend on the IDE, logging and running of external
+ * commands goes through the current host. Default host logs by wxLog
+ * and runs commands through a pipe, the plugin installs a host which
+ * uses CodeLite's logger and ProcUtils.
+ *
+ * Host can be used from worker threads so implementation must be
+ * thread-safe.
+ */
+class CMakeCoreHost
+{
+
+// Public Enums
+public:
+
+
+    /**
+     * @brief Log message levels.
+     */
+    enum LogLevel
+    {
+        LOG_ERROR,
+        LOG_WARNING,
+        LOG_DEBUG
+    };
+
+
+// Public Ctors & Dtors
+public:
+
+
+    /**
+     * @brief Destructor.
+     */
+    virtual ~CMakeCoreHost() {}
+
+
+// Public Operations
+public:
+
+
+    /**
+     * @brief Logs a message.
+     *
+     * @param level   Message level.
+     * @param message Message text.
+     */
+    virtual void Log(LogLevel level, const wxString& message);
+
+
+    /**
+     * @brief Runs a command and waits for its termination.
+     *
+     * @param command Command line.
+     * @param output  Standard output lines of the command (without line
+     *                ends) are appended here.
+     */
+    virtual void Execute(const wxString& command, wxArrayString& output);
+
+
+// Public Static Operations
+public:
+
+
+    /**
+     * @brief Returns current host.
+     *
+     * @return Installed host or the default one.
+     */
+    static CMakeCoreHost& Get();
+
+
+    /**
+     * @brief Installs host.
+     *
+     * Host must outlive all core operations, it's not owned.
+     *
+     * @param host Host or NULL for the default one.
+     */
+    static void Set(CMakeCoreHost* host);
+
+};
+
+/* ************************************************************************ */
+
+#endif // CMAKE_CORE_HOST_H_
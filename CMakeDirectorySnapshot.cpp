@@ -0,0 +1,124 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// Declaration
+#include "CMakeDirectorySnapshot.h"
+
+// wxWidgets
+#include <wx/dir.h>
+#include <wx/log.h>
+#include <wx/time.h>
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+CMakeDirectorySnapshot::CMakeDirectorySnapshot(long maxAge)
+    : m_maxAge(maxAge)
+{
+    // Nothing to do
+}
+
+/* ************************************************************************ */
+
+void
+CMakeDirectorySnapshot::SetWatched(const wxString& directory)
+{
+    m_watched.insert(GetKey(directory));
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeDirectorySnapshot::Exists(const wxFileName& filename)
+{
+    const wxString path = filename.GetPath();
+    const wxString key = GetKey(path);
+    const wxLongLong_t now = wxGetLocalTimeMillis().GetValue();
+
+    std::map<wxString, Directory>::iterator it = m_directories.find(key);
+
+    // Not listed yet or too old
+    if (it == m_directories.end() ||
+        (!m_watched.count(key) && now - it->second.time > m_maxAge)) {
+        if (it == m_directories.end())
+            it = m_directories.insert(std::make_pair(key, Directory())).first;
+
+        List(path, it->second);
+        it->second.time = now;
+    }
+
+    return it->second.names.count(GetKey(filename.GetFullName())) != 0;
+}
+
+/* ************************************************************************ */
+
+void
+CMakeDirectorySnapshot::Invalidate(const wxString& directory)
+{
+    m_directories.erase(GetKey(directory));
+}
+
+/* ************************************************************************ */
+
+void
+CMakeDirectorySnapshot::Clear()
+{
+    m_directories.clear();
+    m_watched.clear();
+}
+
+/* ************************************************************************ */
+
+wxString
+CMakeDirectorySnapshot::GetKey(const wxString& path)
+{
+    if (wxFileName::IsCaseSensitive())
+        return path;
+
+    return path.Lower();
+}
+
+/* ************************************************************************ */
+
+void
+CMakeDirectorySnapshot::List(const wxString& path, Directory& directory)
+{
+    directory.names.clear();
+
+    // Missing directory is not an error
+    wxLogNull noLog;
+    wxDir dir;
+
+    if (!dir.Open(path))
+        return;
+
+    wxString name;
+
+    for (bool cont = dir.GetFirst(&name); cont; cont = dir.GetNext(&name))
+        directory.names.insert(GetKey(name));
+}
+
+/* ************************************************************************ */
@@ -0,0 +1,179 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+#ifndef CMAKE_DIRECTORY_SNAPSHOT_H_
+#define CMAKE_DIRECTORY_SNAPSHOT_H_
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// C++
+#include <map>
+#include <set>
+
+// wxWidgets
+#include <wx/string.h>
+#include <wx/filename.h>
+#include <wx/longlong.h>
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Cache of directory listings for file existence checks.
+ *
+ * Each directory is listed once and following checks of files in the
+ * directory are answered from memory. Listing is taken again when it's
+ * older than the maximum age or when it's invalidated. Listings of
+ * watched directories don't expire, the owner is responsible for
+ * invalidating them when the directory changes.
+ *
+ * Snapshot is not thread safe.
+ */
+class CMakeDirectorySnapshot
+{
+
+// Public Ctors
+public:
+
+
+    /**
+     * @brief Constructor.
+     *
+     * @param maxAge Maximum age of directory listing in milliseconds.
+     */
+    explicit CMakeDirectorySnapshot(long maxAge = 2000);
+
+
+// Public Accessors
+public:
+
+
+    /**
+     * @brief Checks if directory is watched.
+     *
+     * @param directory Directory path.
+     *
+     * @return
+     */
+    bool IsWatched(const wxString& directory) const {
+        return m_watched.count(GetKey(directory)) != 0;
+    }
+
+
+// Public Operations
+public:
+
+
+    /**
+     * @brief Marks directory as watched for changes.
+     *
+     * @param directory Directory path.
+     */
+    void SetWatched(const wxString& directory);
+
+
+    /**
+     * @brief Checks if file or directory exists.
+     *
+     * @param filename Tested file.
+     *
+     * @return
+     */
+    bool Exists(const wxFileName& filename);
+
+
+    /**
+     * @brief Removes listing of the directory.
+     *
+     * @param directory Directory path.
+     */
+    void Invalidate(const wxString& directory);
+
+
+    /**
+     * @brief Removes all listings and watched directories.
+     */
+    void Clear();
+
+
+// Private Structures
+private:
+
+
+    /**
+     * @brief Directory listing.
+     */
+    struct Directory
+    {
+        /// Time of listing (in milliseconds).
+        wxLongLong_t time;
+
+        /// Names of files and subdirectories.
+        std::set<wxString> names;
+    };
+
+
+// Private Operations
+private:
+
+
+    /**
+     * @brief Returns key for the path.
+     *
+     * Key is in lower case on case insensitive file systems.
+     *
+     * @param path Path or file name.
+     *
+     * @return
+     */
+    static wxString GetKey(const wxString& path);
+
+
+    /**
+     * @brief Lists the directory.
+     *
+     * @param path      Directory path.
+     * @param directory Output listing.
+     */
+    static void List(const wxString& path, Directory& directory);
+
+
+// Private Data Members
+private:
+
+
+    /// Maximum age of listing (in milliseconds).
+    long m_maxAge;
+
+    /// Listed directories.
+    std::map<wxString, Directory> m_directories;
+
+    /// Watched directories (keys).
+    std::set<wxString> m_watched;
+
+};
+
+/* ************************************************************************ */
+
+#endif // CMAKE_DIRECTORY_SNAPSHOT_H_
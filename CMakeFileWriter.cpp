@@ -0,0 +1,332 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// Declaration
+#include "CMakeFileWriter.h"
+
+// C++
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+
+// System
+#ifdef __WXMSW__
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+// wxWidgets
+#include <wx/filefn.h>
+#include <wx/utils.h>
+#include <wx/thread.h>
+
+// CMakePlugin
+#include "CMakeMappedFile.h"
+#include "CMakeParseCache.h"
+#include "CMakeCoreHost.h"
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Returns path of the existing file with symbolic links resolved.
+ *
+ * @param filename Path to file.
+ *
+ * @return Resolved path or the given one if it cannot be resolved
+ * (e.g. the file doesn't exist yet).
+ */
+static wxFileName ResolveLinks(const wxFileName& filename)
+{
+#ifdef __WXMSW__
+    return filename;
+#else
+    char* resolved = realpath(filename.GetFullPath().fn_str(), NULL);
+
+    if (!resolved)
+        return filename;
+
+    const wxFileName result(wxString(resolved, *wxConvFileName));
+    free(resolved);
+
+    return result;
+#endif
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Creates a new temporary file next to the target.
+ *
+ * Name contains process and thread identifiers and the file is created
+ * exclusively, so concurrent writers of the same target (other threads
+ * or IDE instances) never share or truncate each other's file.
+ *
+ * @param target Target path.
+ * @param path   Path of the created file.
+ *
+ * @return Opened file or NULL.
+ */
+static FILE* CreateTempFile(const wxString& target, wxString& path)
+{
+    const unsigned long pid = wxGetProcessId();
+    const unsigned long tid = static_cast<unsigned long>(wxThread::GetCurrentId());
+
+    // Leftovers of crashed writers are skipped
+    for (int i = 0; i < 100; ++i) {
+        path = target + wxString::Format(".%lu-%lu-%d.tmp", pid, tid, i);
+
+#ifdef __WXMSW__
+        const int fd = _wopen(path.wc_str(), _O_CREAT | _O_EXCL | _O_WRONLY | _O_BINARY,
+                              _S_IREAD | _S_IWRITE);
+#else
+        // Created with default permissions, unlike wxFileName::CreateTempFileName()
+        const int fd = open(path.fn_str(), O_CREAT | O_EXCL | O_WRONLY, 0666);
+#endif
+
+        if (fd < 0) {
+            if (errno == EEXIST)
+                continue;
+
+            break;
+        }
+
+#ifdef __WXMSW__
+        FILE* file = _fdopen(fd, "wb");
+#else
+        FILE* file = fdopen(fd, "wb");
+#endif
+
+        if (!file) {
+#ifdef __WXMSW__
+            _close(fd);
+#else
+            close(fd);
+#endif
+            wxRemoveFile(path);
+        }
+
+        return file;
+    }
+
+    path.Clear();
+    return NULL;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Gives the file mode and owner of the existing target.
+ *
+ * Replacing file is a new file so without it an executable or
+ * read-only-for-group target would get default permissions. Owner
+ * can be changed only by privileged user, it's best effort.
+ *
+ * @param target Target path.
+ * @param path   Path of the replacing file.
+ */
+static void CopyPermissions(const wxString& target, const wxString& path)
+{
+#ifndef __WXMSW__
+    struct stat st;
+
+    // New target
+    if (stat(target.fn_str(), &st) != 0)
+        return;
+
+    // Group can be kept by its member, otherwise the current owner stays
+    if (chown(path.fn_str(), st.st_uid, st.st_gid) != 0)
+        wxUnusedVar(chown(path.fn_str(), static_cast<uid_t>(-1), st.st_gid));
+
+    // Mode is set after the owner, chown clears set-user-ID bits
+    chmod(path.fn_str(), st.st_mode & 07777);
+#else
+    wxUnusedVar(target);
+    wxUnusedVar(path);
+#endif
+}
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+CMakeFileWriter::CMakeFileWriter(size_t bufferSize)
+    : m_bufferSize(bufferSize ? bufferSize : 1)
+    , m_hash(0)
+    , m_size(0)
+    , m_changed(false)
+    , m_ok(false)
+{
+    // Nothing to do
+}
+
+/* ************************************************************************ */
+
+CMakeFileWriter::~CMakeFileWriter()
+{
+    Discard();
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeFileWriter::Open(const wxFileName& filename)
+{
+    Discard();
+
+    // Renaming over a symbolic link would replace the link by a regular
+    // file, the file it points to is replaced instead
+    m_filename = ResolveLinks(filename);
+
+    FILE* file = CreateTempFile(m_filename.GetFullPath(), m_tempPath);
+
+    if (!file) {
+        CMAKE_ERROR("CMake: unable to create temporary file for '%s'", m_filename.GetFullPath());
+        return false;
+    }
+
+    m_file.Attach(file, m_tempPath);
+
+    m_buffer.reserve(m_bufferSize);
+    m_hash = CMakeParseCache::Hash(NULL, 0);
+    m_size = 0;
+    m_changed = false;
+    m_ok = true;
+
+    return true;
+}
+
+/* ************************************************************************ */
+
+void
+CMakeFileWriter::Write(const char* data, size_t size)
+{
+    m_hash = CMakeParseCache::Hash(data, size, m_hash);
+    m_size += size;
+
+    if (m_buffer.size() + size > m_bufferSize)
+        Flush();
+
+    // Big chunks are not buffered
+    if (size >= m_bufferSize) {
+        if (m_ok && m_file.Write(data, size) != size)
+            m_ok = false;
+    } else {
+        m_buffer.append(data, size);
+    }
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeFileWriter::Commit()
+{
+    if (!m_file.IsOpened())
+        return false;
+
+    Flush();
+
+    if (!m_file.Close())
+        m_ok = false;
+
+    if (!m_ok) {
+        CMAKE_ERROR("CMake: unable to write '%s'", m_tempPath);
+        Discard();
+        return false;
+    }
+
+    // Keep the target untouched
+    if (IsSame()) {
+        Discard();
+        return true;
+    }
+
+    CopyPermissions(m_filename.GetFullPath(), m_tempPath);
+
+    // Replace target
+    if (!wxRenameFile(m_tempPath, m_filename.GetFullPath(), true)) {
+        CMAKE_ERROR("CMake: unable to replace '%s'", m_filename.GetFullPath());
+        Discard();
+        return false;
+    }
+
+    m_tempPath.Clear();
+    m_changed = true;
+
+    return true;
+}
+
+/* ************************************************************************ */
+
+void
+CMakeFileWriter::Discard()
+{
+    if (m_file.IsOpened())
+        m_file.Close();
+
+    if (!m_tempPath.IsEmpty()) {
+        wxRemoveFile(m_tempPath);
+        m_tempPath.Clear();
+    }
+
+    m_buffer.clear();
+    m_ok = false;
+}
+
+/* ************************************************************************ */
+
+void
+CMakeFileWriter::Flush()
+{
+    if (m_buffer.empty())
+        return;
+
+    if (m_ok && m_file.Write(m_buffer.data(), m_buffer.size()) != m_buffer.size())
+        m_ok = false;
+
+    m_buffer.clear();
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeFileWriter::IsSame() const
+{
+    CMakeMappedFile target;
+
+    if (!target.Open(m_filename.GetFullPath()))
+        return false;
+
+    // Size is compared first, it's cheap
+    return target.GetSize() == m_size &&
+           CMakeParseCache::Hash(target.GetData(), target.GetSize()) == m_hash;
+}
+
+/* ************************************************************************ */
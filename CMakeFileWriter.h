@@ -0,0 +1,239 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+#ifndef CMAKE_FILE_WRITER_H_
+#define CMAKE_FILE_WRITER_H_
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// C++
+#include <string>
+#include <cstring>
+
+// wxWidgets
+#include <wx/string.h>
+#include <wx/buffer.h>
+#include <wx/filename.h>
+#include <wx/ffile.h>
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Buffered writer that replaces a file atomically.
+ *
+ * Text is converted to UTF-8 and collected in a buffer of fixed size
+ * which is flushed into a temporary file next to the target. Commit()
+ * renames the temporary file over the target, so readers never see
+ * a partially written file. Uncommitted output is removed by destructor.
+ *
+ * Temporary file has a unique name and is created exclusively, so
+ * concurrent writers of the same target don't clobber each other.
+ * Replaced target keeps its mode (and owner when possible).
+ *
+ * Written data are hashed and when the target has the same content it's
+ * kept untouched, so its modification time doesn't change and cmake
+ * build directories are not reconfigured.
+ *
+ * Target that is a symbolic link is kept, the file it points to
+ * is replaced.
+ */
+class CMakeFileWriter
+{
+
+// Public Ctors & Dtors
+public:
+
+
+    /**
+     * @brief Constructor.
+     *
+     * @param bufferSize Size of the output buffer in bytes.
+     */
+    explicit CMakeFileWriter(size_t bufferSize = 64 * 1024);
+
+
+    /**
+     * @brief Destructor. Discards uncommitted output.
+     */
+    ~CMakeFileWriter();
+
+
+// Public Accessors
+public:
+
+
+    /**
+     * @brief Checks if writer is opened and no error occured.
+     *
+     * @return
+     */
+    bool IsOk() const {
+        return m_file.IsOpened() && m_ok;
+    }
+
+
+    /**
+     * @brief Checks if the last commit changed the target.
+     *
+     * @return
+     */
+    bool IsChanged() const {
+        return m_changed;
+    }
+
+
+// Public Operations
+public:
+
+
+    /**
+     * @brief Creates temporary file for the target.
+     *
+     * @param filename Target file.
+     *
+     * @return If temporary file was created.
+     */
+    bool Open(const wxFileName& filename);
+
+
+    /**
+     * @brief Writes raw UTF-8 data.
+     *
+     * @param data Data.
+     * @param size Data size.
+     */
+    void Write(const char* data, size_t size);
+
+
+    /**
+     * @brief Writes text.
+     *
+     * @param text
+     *
+     * @return this.
+     */
+    CMakeFileWriter& operator<<(const wxString& text) {
+        const wxScopedCharBuffer utf8 = text.utf8_str();
+        Write(utf8.data(), utf8.length());
+        return *this;
+    }
+
+
+    /**
+     * @brief Writes ASCII text.
+     *
+     * @param text
+     *
+     * @return this.
+     */
+    CMakeFileWriter& operator<<(const char* text) {
+        Write(text, strlen(text));
+        return *this;
+    }
+
+
+    /**
+     * @brief Flushes the buffer and replaces the target file.
+     *
+     * Target with the same content is not replaced.
+     *
+     * @return If target has the written content.
+     *
+     * @see IsChanged
+     */
+    bool Commit();
+
+
+    /**
+     * @brief Removes the temporary file.
+     */
+    void Discard();
+
+
+// Private Operations
+private:
+
+
+    /**
+     * @brief Writes buffer into the temporary file.
+     */
+    void Flush();
+
+
+    /**
+     * @brief Checks if the target has the written content.
+     *
+     * @return
+     */
+    bool IsSame() const;
+
+
+// Private Ctors
+private:
+
+
+    /// Not copyable.
+    CMakeFileWriter(const CMakeFileWriter&);
+
+    /// Not copyable.
+    CMakeFileWriter& operator=(const CMakeFileWriter&);
+
+
+// Private Data Members
+private:
+
+
+    /// Target file.
+    wxFileName m_filename;
+
+    /// Path of the temporary file.
+    wxString m_tempPath;
+
+    /// Temporary file.
+    wxFFile m_file;
+
+    /// Output buffer.
+    std::string m_buffer;
+
+    /// Buffer capacity.
+    size_t m_bufferSize;
+
+    /// Hash of the written data.
+    wxUint64 m_hash;
+
+    /// Size of the written data.
+    size_t m_size;
+
+    /// Target was changed by the last commit.
+    bool m_changed;
+
+    /// No error occured.
+    bool m_ok;
+
+};
+
+/* ************************************************************************ */
+
+#endif // CMAKE_FILE_WRITER_H_
@@ -25,14 +25,20 @@
 // Declarations
 #include "CMakeGenerator.h"
 
+// C++
+#include <set>
+
 // wxWidgets
-#include <wx/tokenzr.h>
-#include <wx/ffile.h>
 #include <wx/filename.h>
 #include <wx/msgdlg.h>
+#include <wx/intl.h>
+
+// Codelite
+#include "file_logger.h"
 
 // Plugin
 #include "CMakePlugin.h"
+#include "CMakeListsGenerator.h"
 
 /* ************************************************************************ */
 /* FUNCTIONS                                                                */
@@ -66,72 +72,43 @@ static bool CheckExists(const wxFileName& filename)
 /* ************************************************************************ */
 
 /**
- * @brief Writes content into file.
+ * @brief Returns key which identifies output file.
+ *
+ * Different paths to the same file (relative parts, case on
+ * case-insensitive systems) have the same key.
  *
- * @param filename Output file name.
- * @param content  Written text.
+ * @param filename Output file.
+ *
+ * @return
  */
-static void WriteContent(const wxFileName& filename, const wxString& content)
+static wxString GetOutputKey(const wxFileName& filename)
 {
-    // Write result CMakeLists.txt
-    wxFFile output(filename.GetFullPath(), "w+b");
+    wxFileName normalized(filename);
+    normalized.Normalize(wxPATH_NORM_DOTS | wxPATH_NORM_ABSOLUTE | wxPATH_NORM_CASE);
 
-    if (output.IsOpened()) {
-        output.Write(content);
-        output.Close();
-    }
+    return normalized.GetFullPath();
 }
 
-/* ************************************************************************ */
-/* CLASSES                                                                  */
 /* ************************************************************************ */
 
-void
-CMakeGenerator::Generate(Workspace* workspace)
+/**
+ * @brief Collects data of the workspace.
+ *
+ * Only projects that have CMakeLists.txt are added as subdirectories.
+ *
+ * @param workspace   Exported workspace.
+ * @param directories Snapshot used for existence checks.
+ * @param data        Output data.
+ */
+static void CollectWorkspace(Workspace* workspace, CMakeDirectorySnapshot& directories,
+    CMakeListsGenerator::WorkspaceData& data)
 {
     // Get workspace directory.
     const wxFileName workspaceDir = workspace->GetWorkspaceFileName().
         GetPath(wxPATH_GET_SEPARATOR | wxPATH_GET_VOLUME);
 
-    // Output file name
-    const wxFileName filename(workspaceDir.GetPath(), CMakePlugin::CMAKELISTS_FILE);
-
-    if (!CheckExists(filename))
-        return;
-
-    // File content
-    wxString content;
-
-    // Print project name
-    content << "# Workspace name\n";
-    content << "project(" << workspace->GetName() << ")\n\n";
-
-    // Environment variables
-    {
-        wxString variables = workspace->GetEnvironmentVariabels(); // Nice typo
-        variables.Trim().Trim(false);
-
-        if (!variables.IsEmpty()) {
-            // Split into a list of pairs
-            const wxArrayString list = wxStringTokenize(variables, "\n;");
-
-            for (wxArrayString::const_iterator it = list.begin(),
-                ite = list.end(); it != ite; ++it) {
-                // Split into name, value pair
-                const wxArrayString pair = wxSplit(*it, '=');
-
-                const wxString& name = pair[0];
-                const wxString value = (pair.GetCount() >= 2) ? pair[1] : "";
-
-                // Set environment variable
-                content << "set(" << name << " \"" << value << "\")\n";
-            }
-
-            content << "\n";
-        }
-    }
-
-    content << "# Projects\n";
+    data.name = workspace->GetName();
+    data.environment = workspace->GetEnvironmentVariabels(); // Nice typo
 
     // Get full paths to all projects
     const wxArrayString projects = workspace->GetAllProjectPaths();
@@ -140,51 +117,35 @@ CMakeGenerator::Generate(Workspace* workspace)
     for (wxArrayString::const_iterator it = projects.begin(),
         ite = projects.end(); it != ite; ++it) {
         wxFileName fullpath = *it;
-        fullpath.MakeRelativeTo(workspaceDir.GetPath());
 
         // Create path to CMakeLists.txt in the project
         const wxFileName cmakelist(fullpath.GetPath(), CMakePlugin::CMAKELISTS_FILE);
 
         // Skip directories without CMakeLists.txt
-        if (!cmakelist.Exists())
+        if (!directories.Exists(cmakelist))
             continue;
 
-        // Write
-        content << "add_subdirectory(" << fullpath.GetPath() << ")\n";
+        fullpath.MakeRelativeTo(workspaceDir.GetPath());
+        data.subdirectories.Add(fullpath.GetPath());
     }
-
-    // Write result
-    WriteContent(filename, content);
 }
 
 /* ************************************************************************ */
 
-void
-CMakeGenerator::Generate(ProjectPtr project, BuildConfigPtr configuration,
-    CompilerPtr compiler)
+/**
+ * @brief Collects data of the project.
+ *
+ * @param project       Project.
+ * @param configuration Build configuration.
+ * @param compiler      Optional compiler.
+ * @param data          Output data.
+ */
+static void CollectProject(ProjectPtr project, BuildConfigPtr configuration,
+    CompilerPtr compiler, CMakeListsGenerator::ProjectData& data)
 {
-    wxASSERT(project);
-    wxASSERT(configuration);
-
-    // Get project directory
-    const wxFileName projectDir = project->GetFileName().GetPath(wxPATH_GET_SEPARATOR | wxPATH_GET_VOLUME);
-
-    // Output file name
-    const wxFileName filename(projectDir.GetPath(), CMakePlugin::CMAKELISTS_FILE);
-
-    if (!CheckExists(filename))
-        return;
-
-    // File content
-    wxString content;
-
-    // TODO custom version
-    content << "cmake_minimum_required(VERSION 2.6.2)\n\n";
-
-    // Print project name
-    content << "project(" << project->GetName() << ")\n\n";
+    data.name = project->GetName();
 
-    // Add include directories
+    // Include directories from configuration, project and compiler
     {
         wxString includes = configuration->GetIncludePath();
 
@@ -199,137 +160,226 @@ CMakeGenerator::Generate(ProjectPtr project, BuildConfigPtr configuration,
             includes << ";" << compiler->GetGlobalIncludePath();
         }
 
-        // Trim all whitespaces
-        includes.Trim().Trim(false);
+        data.includePaths = includes;
+    }
 
-        // Ignore empty include paths
-        if (!includes.IsEmpty()) {
-            // Separators
-            includes.Replace(";", "\n    ");
-            // Replace Windows backslashes
-            includes.Replace("\\", "/");
+    data.definitions = configuration->GetPreprocessor();
+    data.compileOptions = configuration->GetCompileOptions();
+    data.linkOptions = configuration->GetLinkOptions();
+    data.libraryPaths = configuration->GetLibPath();
+    data.libraries = configuration->GetLibraries();
 
-            content << "include_directories(\n    " << includes << "\n)\n\n";
-        }
+    // Get switch and global library paths from compiler
+    if (compiler) {
+        data.libraryPathSwitch = compiler->GetSwitch("LibraryPath");
+        data.libraryPaths << ";" << compiler->GetGlobalLibPath();
     }
 
-    // Add preprocessor definitions
+    // Sources
     {
-        wxString defines = configuration->GetPreprocessor();
+        // Get files in the project
+        std::vector<wxFileName> files;
+        project->GetFiles(files, true);
 
-        defines.Trim().Trim(false);
-        defines.Replace(";", "\n    -D");
+        data.sources.Alloc(files.size());
 
-        if (!defines.IsEmpty())
-        {
-            content << "add_definitions(\n    -D" << defines << "\n)\n\n";
+        for (size_t i = 0; i < files.size(); i++) {
+            wxFileName src_filename = files.at(i);
+            src_filename.MakeRelativeTo(project->GetFileName().GetPath());
+
+            data.sources.Add(src_filename.GetFullPath(wxPATH_UNIX));
         }
     }
 
-    // Add compiler options
+    // Get project type
     {
-        wxString buildOpts = configuration->GetCompileOptions();
+        ProjectSettingsPtr settings = project->GetSettings();
 
-        buildOpts.Trim().Trim(false);
-        buildOpts.Replace(";", " ");
+        wxString type = settings->GetProjectType(configuration->GetName());
 
-        if (!buildOpts.IsEmpty()) {
-            content << "set(CMAKE_CXXFLAGS \"${CMAKE_CXXFLAGS} " << buildOpts << "\")\n\n";
+        if (type == Project::EXECUTABLE) {
+            data.type = CMakeListsGenerator::TargetExecutable;
+        } else if (type == Project::DYNAMIC_LIBRARY) {
+            data.type = CMakeListsGenerator::TargetSharedLibrary;
+        } else {
+            data.type = CMakeListsGenerator::TargetStaticLibrary;
         }
     }
+}
 
-    // Add linker options
-    {
-        wxString links = configuration->GetLinkOptions();
+/* ************************************************************************ */
 
-        links.Trim().Trim(false);
-        links.Replace(";", " ");
+/**
+ * @brief Returns path to CMakeLists.txt of the workspace.
+ *
+ * @param workspace Workspace.
+ *
+ * @return
+ */
+static wxFileName GetWorkspaceFile(Workspace* workspace)
+{
+    return wxFileName(workspace->GetWorkspaceFileName().GetPath(), CMakePlugin::CMAKELISTS_FILE);
+}
 
-        if (!links.IsEmpty()) {
-            content << "# Linker options\n";
-            content << "set(CMAKE_LDFLAGS \"${CMAKE_LDFLAGS} " << links << "\")\n\n";
-        }
+/* ************************************************************************ */
+
+/**
+ * @brief Returns path to CMakeLists.txt of the project.
+ *
+ * @param project Project.
+ *
+ * @return
+ */
+static wxFileName GetProjectFile(ProjectPtr project)
+{
+    return wxFileName(project->GetFileName().GetPath(), CMakePlugin::CMAKELISTS_FILE);
+}
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+void
+CMakeGenerator::Generate(Workspace* workspace, CMakeDirectorySnapshot& directories)
+{
+    // Output file name
+    const wxFileName filename = GetWorkspaceFile(workspace);
+
+    if (!CheckExists(filename))
+        return;
+
+    CMakeListsGenerator::WorkspaceData data;
+    CollectWorkspace(workspace, directories, data);
+
+    // Write result
+    CMakeFileWriter output;
+
+    if (output.Open(filename)) {
+        CMakeListsGenerator::GenerateWorkspace(data, output);
+        output.Commit();
     }
 
-    // Add libraries paths
-    {
-        wxString lib_paths = configuration->GetLibPath();
-        wxString lib_switch = "-L";
+    directories.Invalidate(filename.GetPath());
+}
 
-        // Get switch from compiler
-        if (compiler) {
-            lib_switch = compiler->GetSwitch("LibraryPath");
+/* ************************************************************************ */
 
-            // Append global library paths
-            lib_paths << ";" << compiler->GetGlobalLibPath();
-        }
+void
+CMakeGenerator::Generate(ProjectPtr project, BuildConfigPtr configuration,
+    CompilerPtr compiler)
+{
+    wxASSERT(project);
+    wxASSERT(configuration);
 
-        // Get list of library paths
-        wxArrayString lib_paths_list = wxStringTokenize(lib_paths, ";", wxTOKEN_STRTOK);
+    // Output file name
+    const wxFileName filename = GetProjectFile(project);
 
-        // Clear string
-        lib_paths.Clear();
+    if (!CheckExists(filename))
+        return;
 
-        // Append modified values
-        for (size_t i = 0; i < lib_paths_list.GetCount(); ++i) {
-            lib_paths << lib_switch << "\\\"" << lib_paths_list.Item(i) << "\\\" ";
-        }
+    CMakeListsGenerator::ProjectData data;
+    CollectProject(project, configuration, compiler, data);
 
-        content << "# Library path\n";
-        content << "set(CMAKE_LDFLAGS \"${CMAKE_LDFLAGS} " << lib_paths << "\")\n\n";
+    // Write result
+    CMakeFileWriter output;
+
+    if (output.Open(filename)) {
+        CMakeListsGenerator::GenerateProject(data, output);
+        output.Commit();
     }
+}
 
-    // Write sources
-    {
-        content << "set(SRCS\n";
+/* ************************************************************************ */
 
-        // Get files in the project
-        std::vector<wxFileName> files;
-        project->GetFiles(files, true);
+size_t
+CMakeGenerator::GenerateAll(Workspace* workspace, CMakeDirectorySnapshot& directories)
+{
+    wxArrayString names;
+    workspace->GetProjectList(names);
 
-        for (size_t i = 0; i < files.size(); i++) {
-            wxFileName src_filename = files.at(i);
-            src_filename.MakeRelativeTo(project->GetFileName().GetPath());
+    const wxFileName filename = GetWorkspaceFile(workspace);
+
+    // Each file is written only once, workers would replace the same
+    // file concurrently
+    std::set<wxString> outputs;
+    outputs.insert(GetOutputKey(filename));
+
+    // Collect data in the main thread, workspace is not thread safe
+    wxVector<CMakeListsGenerator::ProjectFile> projects;
+    projects.reserve(names.GetCount());
+
+    unsigned int existing = 0;
 
-            // Store file name into SRCS
-            content << "    " << src_filename.GetFullPath(wxPATH_UNIX) << "\n";
+    for (wxArrayString::const_iterator it = names.begin(),
+        ite = names.end(); it != ite; ++it) {
+        wxString err;
+        ProjectPtr project = workspace->FindProjectByName(*it, err);
+
+        if (!project)
+            continue;
+
+        // Active configuration of the project
+        BuildConfigPtr configuration = workspace->GetProjBuildConf(*it, wxEmptyString);
+
+        if (!configuration)
+            continue;
+
+        const wxFileName projectFile = GetProjectFile(project);
+
+        if (!outputs.insert(GetOutputKey(projectFile)).second) {
+            CL_WARNING("CMake: project '%s' is skipped, '%s' is generated for another project or the workspace",
+                *it, projectFile.GetFullPath());
+            continue;
         }
 
-        content << ")\n\n";
+        projects.push_back(CMakeListsGenerator::ProjectFile());
+        CMakeListsGenerator::ProjectFile& file = projects.back();
+        file.filename = projectFile;
+        CollectProject(project, configuration, NULL, file.data);
+
+        if (directories.Exists(file.filename))
+            ++existing;
     }
 
-    // Get project type
-    {
-        ProjectSettingsPtr settings = project->GetSettings();
+    if (directories.Exists(filename))
+        ++existing;
 
-        wxString type = settings->GetProjectType(configuration->GetName());
+    // Ask only once for all files
+    if (existing) {
+        int res = wxMessageBox(wxString::Format(wxPLURAL("%u %s file exists. Overwrite?",
+            "%u %s files exist. Overwrite?", existing), existing, CMakePlugin::CMAKELISTS_FILE),
+            wxMessageBoxCaptionStr, wxYES | wxNO | wxCENTER | wxICON_QUESTION);
 
-        if (type == Project::EXECUTABLE) {
-            content << "add_executable(" << project->GetName() << " ${SRCS})\n\n";
-        } else if (type == Project::DYNAMIC_LIBRARY) {
-            content << "add_library(" << project->GetName() << " SHARED ${SRCS})\n\n";
-        } else {
-            content << "add_library(" << project->GetName() << " ${SRCS})\n\n";
-        }
+        if (res != wxYES)
+            return 0;
     }
 
-    // Add link libraries
-    {
-        wxString libs = configuration->GetLibraries();
+    // Generate projects in parallel
+    size_t changed = CMakeListsGenerator::GenerateProjects(projects);
 
-        libs.Trim().Trim(false);
+    // Listings are outdated now
+    for (wxVector<CMakeListsGenerator::ProjectFile>::const_iterator it = projects.begin(),
+        ite = projects.end(); it != ite; ++it) {
+        directories.Invalidate(it->filename.GetPath());
+    }
 
-        if (!libs.IsEmpty()) {
-            libs.Replace(";", "\n    ");
-            content << "target_link_libraries(" <<
-                project->GetName() << "\n    " <<
-                libs << "\n)\n\n";
-        }
+    // Workspace must be collected after projects are written because
+    // it adds only projects with CMakeLists.txt
+    CMakeListsGenerator::WorkspaceData data;
+    CollectWorkspace(workspace, directories, data);
+
+    CMakeFileWriter output;
+
+    if (output.Open(filename)) {
+        CMakeListsGenerator::GenerateWorkspace(data, output);
+
+        if (output.Commit() && output.IsChanged())
+            ++changed;
     }
 
-    // Write result
-    WriteContent(filename, content);
+    directories.Invalidate(filename.GetPath());
+
+    return changed;
 }
 
 /* ************************************************************************ */
-
@@ -31,12 +31,18 @@
 #include "build_config.h"
 #include "compiler.h"
 
+// CMakePlugin
+#include "CMakeDirectorySnapshot.h"
+
 /* ************************************************************************ */
 /* CLASSES                                                                  */
 /* ************************************************************************ */
 
 /**
  * @brief The CMakeLists.txt generator.
+ *
+ * Collects data from CodeLite workspace and projects, the content
+ * is generated by CMakeListsGenerator.
  */
 class CMakeGenerator
 {
@@ -52,9 +58,11 @@ public:
      * (like subdirectories) that have CMakeLists.txt. Others are
      * ignored.
      *
-     * @param workspace Exported workspace.
+     * @param workspace   Exported workspace.
+     * @param directories Snapshot used for existence checks of projects
+     *                    CMakeLists.txt.
      */
-    static void Generate(Workspace* workspace);
+    static void Generate(Workspace* workspace, CMakeDirectorySnapshot& directories);
 
 
     /**
@@ -69,6 +77,25 @@ public:
                          BuildConfigPtr configuration,
                          CompilerPtr compiler = NULL);
 
+
+    /**
+     * @brief Generate CMakeLists.txt files for all projects and
+     * the workspace.
+     *
+     * Projects use their active build configuration and are generated
+     * in parallel. The workspace file is written at the end so it
+     * includes all generated projects. Files with unchanged content
+     * are not rewritten. Project whose file is already generated for
+     * another project or the workspace is skipped with a warning.
+     *
+     * @param workspace   Exported workspace.
+     * @param directories Snapshot used for existence checks, directories
+     *                    of generated projects are invalidated.
+     *
+     * @return Number of changed files.
+     */
+    static size_t GenerateAll(Workspace* workspace, CMakeDirectorySnapshot& directories);
+
 };
 
 /* ************************************************************************ */
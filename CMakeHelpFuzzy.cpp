@@ -0,0 +1,406 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// Declaration
+#include "CMakeHelpFuzzy.h"
+
+// C++
+#include <cctype>
+#include <algorithm>
+
+// SSE2 is a part of x86-64 and it can be enabled on x86
+#if !defined(CMAKEPLUGIN_NO_SIMD) && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define CMAKE_HELP_FUZZY_SSE2 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+/* ************************************************************************ */
+/* VARIABLES                                                                */
+/* ************************************************************************ */
+
+/// Score of each matched character.
+static const int SCORE_MATCH = 16;
+
+/// Bonus for matching the first character of the name.
+static const int BONUS_FIRST = 10;
+
+/// Bonus for matching a character after separator ('_', '-', ...).
+static const int BONUS_BOUNDARY = 8;
+
+/// Bonus for matching an upper-case character after lower-case one.
+static const int BONUS_CAMEL = 7;
+
+/// Bonus for each matched character that follows a matched character.
+static const int BONUS_CONSECUTIVE = 4;
+
+/// Penalty for the first skipped character.
+static const int PENALTY_GAP_START = 3;
+
+/// Penalty for each next skipped character.
+static const int PENALTY_GAP_EXTENSION = 1;
+
+/// Replacement of non-ASCII characters.
+static const unsigned char NON_ASCII = 0x80;
+
+/// Size of vector register in bytes.
+static const size_t VECTOR_SIZE = 16;
+
+/* ************************************************************************ */
+/* STRUCTURES                                                               */
+/* ************************************************************************ */
+
+/**
+ * @brief Scored name used for sorting.
+ */
+struct ScoredEntry
+{
+    /// Name score.
+    int score;
+
+    /// Name length.
+    size_t length;
+
+    /// Entry number.
+    size_t entry;
+
+
+    /**
+     * @brief Higher score first, then shorter name, then entry order.
+     *
+     * @param other
+     *
+     * @return
+     */
+    bool operator<(const ScoredEntry& other) const
+    {
+        if (score != other.score)
+            return score > other.score;
+
+        if (length != other.length)
+            return length < other.length;
+
+        return entry < other.entry;
+    }
+};
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Converts character into lower-case ASCII.
+ *
+ * @param ch
+ *
+ * @return
+ */
+static unsigned char ToLowerAscii(wxUniChar ch)
+{
+    const wxUint32 value = ch.GetValue();
+
+    if (value >= 0x80)
+        return NON_ASCII;
+
+    return static_cast<unsigned char>(std::tolower(static_cast<int>(value)));
+}
+
+/* ************************************************************************ */
+
+#ifdef CMAKE_HELP_FUZZY_SSE2
+
+/**
+ * @brief Returns number of trailing zero bits.
+ *
+ * @param value Non-zero value.
+ *
+ * @return
+ */
+static unsigned CountTrailingZeros(unsigned value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return index;
+#else
+    return __builtin_ctz(value);
+#endif
+}
+
+#endif
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+CMakeHelpFuzzy::CMakeHelpFuzzy()
+{
+    // Nothing to do
+}
+
+/* ************************************************************************ */
+
+const char*
+CMakeHelpFuzzy::GetKernelName()
+{
+#ifdef CMAKE_HELP_FUZZY_SSE2
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+/* ************************************************************************ */
+
+void
+CMakeHelpFuzzy::Clear()
+{
+    m_chars.clear();
+    m_bonuses.clear();
+    m_entries.clear();
+}
+
+/* ************************************************************************ */
+
+void
+CMakeHelpFuzzy::Build(const CMakeHelpIndex* indices, size_t count)
+{
+    Clear();
+
+    for (size_t i = 0; i < count; ++i) {
+        const CMakeHelpIndex& index = indices[i];
+
+        for (size_t pos = 0; pos < index.GetCount(); ++pos) {
+            const wxString& name = index.GetName(pos);
+
+            Entry entry;
+            entry.offset = m_chars.size();
+            entry.length = name.length();
+            entry.mask = 0;
+            entry.item = CMakeHelpIndex::Item(&index, pos);
+
+            // Previous original character
+            wxUint32 prev = 0;
+
+            for (size_t j = 0; j < name.length(); ++j) {
+                const wxUint32 value = name[j].GetValue();
+                const unsigned char ch = ToLowerAscii(name[j]);
+
+                const bool alnum = value < 0x80 && std::isalnum(static_cast<int>(value));
+                const bool prevAlnum = prev < 0x80 && std::isalnum(static_cast<int>(prev));
+
+                // Character bonus
+                int bonus = 0;
+
+                if (j == 0)
+                    bonus = BONUS_FIRST;
+                else if (alnum && !prevAlnum)
+                    bonus = BONUS_BOUNDARY;
+                else if (value < 0x80 && prev < 0x80 && std::islower(static_cast<int>(prev)) && std::isupper(static_cast<int>(value)))
+                    bonus = BONUS_CAMEL;
+
+                m_chars.push_back(ch);
+                m_bonuses.push_back(static_cast<unsigned char>(bonus));
+                entry.mask |= GetMaskBit(ch);
+
+                prev = value;
+            }
+
+            m_entries.push_back(entry);
+        }
+    }
+
+    // Vector loads can read after the last name
+    m_chars.resize(m_chars.size() + VECTOR_SIZE, 0);
+    m_bonuses.resize(m_bonuses.size() + VECTOR_SIZE, 0);
+}
+
+/* ************************************************************************ */
+
+void
+CMakeHelpFuzzy::Match(const wxString& query, CMakeHelpIndex::Items& result,
+                      size_t limit) const
+{
+    result.clear();
+
+    // Lower-case query without spaces
+    std::vector<unsigned char> chars;
+    wxUint64 mask = 0;
+
+    for (wxString::const_iterator it = query.begin(), ite = query.end(); it != ite; ++it) {
+        const unsigned char ch = ToLowerAscii(*it);
+
+        if (ch == ' ' || ch == '\t')
+            continue;
+
+        chars.push_back(ch);
+        mask |= GetMaskBit(ch);
+    }
+
+    if (chars.empty())
+        return;
+
+    std::vector<ScoredEntry> scored;
+
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        const Entry& entry = m_entries[i];
+
+        // Some characters are missing
+        if ((entry.mask & mask) != mask || entry.length < chars.size())
+            continue;
+
+        const int score = Score(entry, &chars[0], chars.size());
+
+        if (score < 0)
+            continue;
+
+        const ScoredEntry item = {score, entry.length, i};
+        scored.push_back(item);
+    }
+
+    // Sort only required part
+    if (scored.size() > limit) {
+        std::partial_sort(scored.begin(), scored.begin() + limit, scored.end());
+        scored.resize(limit);
+    } else {
+        std::sort(scored.begin(), scored.end());
+    }
+
+    result.reserve(scored.size());
+
+    for (std::vector<ScoredEntry>::const_iterator it = scored.begin(), ite = scored.end(); it != ite; ++it) {
+        result.push_back(m_entries[it->entry].item);
+    }
+}
+
+/* ************************************************************************ */
+
+size_t
+CMakeHelpFuzzy::Find(const unsigned char* chars, size_t pos, size_t length,
+                     unsigned char ch)
+{
+#ifdef CMAKE_HELP_FUZZY_SSE2
+    const __m128i needle = _mm_set1_epi8(static_cast<char>(ch));
+
+    for (; pos < length; pos += VECTOR_SIZE) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars + pos));
+        const unsigned bits = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+
+        if (bits)
+            return std::min(pos + CountTrailingZeros(bits), length);
+    }
+
+    return length;
+#else
+    for (; pos < length; ++pos) {
+        if (chars[pos] == ch)
+            return pos;
+    }
+
+    return length;
+#endif
+}
+
+/* ************************************************************************ */
+
+wxUint64
+CMakeHelpFuzzy::GetMaskBit(unsigned char ch)
+{
+    if (ch >= 'a' && ch <= 'z')
+        return wxUint64(1) << (ch - 'a');
+
+    if (ch >= '0' && ch <= '9')
+        return wxUint64(1) << (26 + ch - '0');
+
+    if (ch == '_')
+        return wxUint64(1) << 36;
+
+    return wxUint64(1) << 37;
+}
+
+/* ************************************************************************ */
+
+int
+CMakeHelpFuzzy::Score(const Entry& entry, const unsigned char* query, size_t length) const
+{
+    const unsigned char* chars = &m_chars[entry.offset];
+    const unsigned char* bonuses = &m_bonuses[entry.offset];
+
+    // Find the end of the first occurrence
+    size_t end = 0;
+    size_t q = 0;
+
+    for (; q < length; ++q) {
+        end = Find(chars, end, entry.length, query[q]);
+
+        // Not all characters found
+        if (end == entry.length)
+            return -1;
+
+        ++end;
+    }
+
+    // Find the shortest window by scanning backward
+    size_t start = end;
+    q = length;
+
+    while (q > 0) {
+        --start;
+
+        if (chars[start] == query[q - 1])
+            --q;
+    }
+
+    // Score the window
+    int score = 0;
+    int consecutive = 0;
+    int gap = 0;
+    q = 0;
+
+    for (size_t i = start; i < end && q < length; ++i) {
+        if (chars[i] == query[q]) {
+            score += SCORE_MATCH + bonuses[i];
+
+            if (consecutive)
+                score += BONUS_CONSECUTIVE * consecutive;
+
+            ++consecutive;
+            gap = 0;
+            ++q;
+        } else {
+            score -= gap ? PENALTY_GAP_EXTENSION : PENALTY_GAP_START;
+            consecutive = 0;
+            ++gap;
+        }
+    }
+
+    // Negative value means no match
+    return std::max(score, 0);
+}
+
+/* ************************************************************************ */
@@ -0,0 +1,194 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+#ifndef CMAKE_HELP_FUZZY_H_
+#define CMAKE_HELP_FUZZY_H_
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// C++
+#include <vector>
+
+// wxWidgets
+#include <wx/string.h>
+
+// CMakePlugin
+#include "CMakeHelpIndex.h"
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Fuzzy matcher of help item names from several indices.
+ *
+ * Query matches a name if all query characters are found in the name
+ * in the same order (case insensitive). Matches are scored like fzf
+ * does: characters at word starts and consecutive characters get
+ * a bonus, gaps are penalized.
+ *
+ * All names are packed into a single lower-case buffer with a parallel
+ * buffer of per-character bonuses. Each name has a character-set mask
+ * so most of names are rejected by a single bit test before scanning.
+ * Remaining names are scanned for query characters 16 bytes at once
+ * when SSE2 is available (define CMAKEPLUGIN_NO_SIMD to disable it).
+ */
+class CMakeHelpFuzzy
+{
+
+// Public Ctors
+public:
+
+
+    /**
+     * @brief Constructor.
+     */
+    CMakeHelpFuzzy();
+
+
+// Public Accessors
+public:
+
+
+    /**
+     * @brief Returns name of the used scanning kernel.
+     *
+     * @return "SSE2" or "scalar".
+     */
+    static const char* GetKernelName();
+
+
+// Public Operations
+public:
+
+
+    /**
+     * @brief Removes all names.
+     */
+    void Clear();
+
+
+    /**
+     * @brief Builds matcher from names of given indices.
+     *
+     * Indices must live as long as the matcher is used.
+     *
+     * @param indices Array of indices.
+     * @param count   Number of indices.
+     */
+    void Build(const CMakeHelpIndex* indices, size_t count);
+
+
+    /**
+     * @brief Finds names that match query.
+     *
+     * @param query  Searched characters.
+     * @param result Output items ordered by score (best first).
+     * @param limit  Maximum number of items.
+     */
+    void Match(const wxString& query, CMakeHelpIndex::Items& result,
+               size_t limit = 200) const;
+
+
+// Private Structures
+private:
+
+
+    /**
+     * @brief Packed name.
+     */
+    struct Entry
+    {
+        /// Offset in the buffers.
+        size_t offset;
+
+        /// Name length.
+        size_t length;
+
+        /// Set of contained characters.
+        wxUint64 mask;
+
+        /// Name in index.
+        CMakeHelpIndex::Item item;
+    };
+
+
+// Private Operations
+private:
+
+
+    /**
+     * @brief Returns character mask bit.
+     *
+     * @param ch Lower-case character.
+     *
+     * @return
+     */
+    static wxUint64 GetMaskBit(unsigned char ch);
+
+
+    /**
+     * @brief Finds character in the packed name.
+     *
+     * @param chars  Name characters, the buffer must be readable
+     *               at least 16 bytes after the name.
+     * @param pos    Start position.
+     * @param length Name length.
+     * @param ch     Searched character.
+     *
+     * @return Character position or length if it's not found.
+     */
+    static size_t Find(const unsigned char* chars, size_t pos, size_t length,
+                       unsigned char ch);
+
+
+    /**
+     * @brief Scores one name.
+     *
+     * @param entry  Name entry.
+     * @param query  Lower-case query.
+     * @param length Query length.
+     *
+     * @return Score or negative value if name doesn't match.
+     */
+    int Score(const Entry& entry, const unsigned char* query, size_t length) const;
+
+
+// Private Data Members
+private:
+
+
+    /// Packed lower-case names (padded by zeros for vector loads).
+    std::vector<unsigned char> m_chars;
+
+    /// Bonus for matching character at the same position.
+    std::vector<unsigned char> m_bonuses;
+
+    /// Names.
+    std::vector<Entry> m_entries;
+
+};
+
+/* ************************************************************************ */
+
+#endif // CMAKE_HELP_FUZZY_H_
@@ -0,0 +1,168 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// Declaration
+#include "CMakeHelpIndex.h"
+
+// C++
+#include <algorithm>
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+CMakeHelpIndex::CMakeHelpIndex()
+    : m_data(NULL)
+{
+    // Nothing to do
+}
+
+/* ************************************************************************ */
+
+void
+CMakeHelpIndex::Clear()
+{
+    m_data = NULL;
+    m_names.Clear();
+    m_trigrams.clear();
+}
+
+/* ************************************************************************ */
+
+void
+CMakeHelpIndex::Build(const CMake::HelpMap& data)
+{
+    Clear();
+
+    m_data = &data;
+
+    // Map is already sorted
+    m_names.Alloc(data.size());
+
+    for (CMake::HelpMap::const_iterator it = data.begin(), ite = data.end(); it != ite; ++it) {
+        m_names.Add(it->first);
+    }
+
+    // Collect trigrams
+    for (size_t i = 0; i < m_names.GetCount(); ++i) {
+        const wxString& name = m_names[i];
+
+        for (size_t j = 0; j + 3 <= name.length(); ++j) {
+            m_trigrams.push_back(Entry(MakeTrigram(name, j), i));
+        }
+    }
+
+    // Sort by key and position, remove repeated trigrams of the same name
+    std::sort(m_trigrams.begin(), m_trigrams.end());
+    m_trigrams.erase(std::unique(m_trigrams.begin(), m_trigrams.end()), m_trigrams.end());
+}
+
+/* ************************************************************************ */
+
+void
+CMakeHelpIndex::Filter(const wxString& search, Positions& result) const
+{
+    result.clear();
+
+    // Wildcards, test all names
+    if (search.find_first_of("*?") != wxString::npos) {
+        const wxString pattern = "*" + search + "*";
+
+        for (size_t i = 0; i < m_names.GetCount(); ++i) {
+            if (m_names[i].Matches(pattern))
+                result.push_back(i);
+        }
+
+        return;
+    }
+
+    // Too short for trigrams, test all names
+    if (search.length() < 3) {
+        for (size_t i = 0; i < m_names.GetCount(); ++i) {
+            if (m_names[i].find(search) != wxString::npos)
+                result.push_back(i);
+        }
+
+        return;
+    }
+
+    // Find the trigram with the least names
+    std::vector<Entry>::const_iterator first = m_trigrams.end();
+    std::vector<Entry>::const_iterator last = m_trigrams.end();
+
+    for (size_t j = 0; j + 3 <= search.length(); ++j) {
+        const Trigram key = MakeTrigram(search, j);
+
+        const std::vector<Entry>::const_iterator lower = std::lower_bound(
+            m_trigrams.begin(), m_trigrams.end(), Entry(key, 0));
+        const std::vector<Entry>::const_iterator upper = std::lower_bound(
+            lower, m_trigrams.end(), Entry(key + 1, 0));
+
+        // Trigram is not part of any name
+        if (lower == upper)
+            return;
+
+        if (first == m_trigrams.end() || (upper - lower) < (last - first)) {
+            first = lower;
+            last = upper;
+        }
+    }
+
+    // Test only candidates
+    for (; first != last; ++first) {
+        if (m_names[first->second].find(search) != wxString::npos)
+            result.push_back(first->second);
+    }
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeHelpIndex::Find(const wxString& name, size_t& pos) const
+{
+    // Names are sorted
+    wxArrayString::const_iterator it = std::lower_bound(m_names.begin(), m_names.end(), name);
+
+    if (it == m_names.end() || *it != name)
+        return false;
+
+    pos = it - m_names.begin();
+    return true;
+}
+
+/* ************************************************************************ */
+
+CMakeHelpIndex::Trigram
+CMakeHelpIndex::MakeTrigram(const wxString& str, size_t pos)
+{
+    // Unicode code point takes at most 21 bits
+    return
+        (static_cast<Trigram>(str[pos].GetValue()) << 42) |
+        (static_cast<Trigram>(str[pos + 1].GetValue()) << 21) |
+        (static_cast<Trigram>(str[pos + 2].GetValue()))
+    ;
+}
+
+/* ************************************************************************ */
@@ -0,0 +1,209 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+#ifndef CMAKE_HELP_INDEX_H_
+#define CMAKE_HELP_INDEX_H_
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// C++
+#include <vector>
+#include <utility>
+
+// wxWidgets
+#include <wx/string.h>
+#include <wx/arrstr.h>
+
+// CMakePlugin
+#include "CMake.h"
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Index of help item names used for fast filtering.
+ *
+ * Names are stored in a sorted array. For each trigram (three
+ * consecutive characters) of each name the index stores the name
+ * position, so the names that contain searched string can be found
+ * without testing all names.
+ */
+class CMakeHelpIndex
+{
+
+// Public Types
+public:
+
+
+    /// List of positions in the names array.
+    typedef std::vector<size_t> Positions;
+
+    /// Name from any index (index and position).
+    typedef std::pair<const CMakeHelpIndex*, size_t> Item;
+
+    /// List of names from any index.
+    typedef std::vector<Item> Items;
+
+
+// Public Ctors
+public:
+
+
+    /**
+     * @brief Constructor.
+     */
+    CMakeHelpIndex();
+
+
+// Public Accessors
+public:
+
+
+    /**
+     * @brief Returns help list the index was built from.
+     *
+     * @return
+     */
+    const CMake::HelpMap* GetData() const {
+        return m_data;
+    }
+
+
+    /**
+     * @brief Returns sorted list of all names.
+     *
+     * @return
+     */
+    const wxArrayString& GetNames() const {
+        return m_names;
+    }
+
+
+    /**
+     * @brief Returns number of names.
+     *
+     * @return
+     */
+    size_t GetCount() const {
+        return m_names.GetCount();
+    }
+
+
+    /**
+     * @brief Returns name at given position.
+     *
+     * @param pos
+     *
+     * @return
+     */
+    const wxString& GetName(size_t pos) const {
+        return m_names[pos];
+    }
+
+
+// Public Operations
+public:
+
+
+    /**
+     * @brief Removes everything from the index.
+     */
+    void Clear();
+
+
+    /**
+     * @brief Builds index from help list names.
+     *
+     * @param data Help list.
+     */
+    void Build(const CMake::HelpMap& data);
+
+
+    /**
+     * @brief Finds names that contain search string.
+     *
+     * Search string with wildcards ('*', '?') can match anywhere
+     * in names, like "*search*" pattern in wxString::Matches.
+     *
+     * @param search Search string.
+     * @param result Output positions in the names array in ascending order.
+     */
+    void Filter(const wxString& search, Positions& result) const;
+
+
+    /**
+     * @brief Finds position of the name.
+     *
+     * @param name Name.
+     * @param pos  Output position.
+     *
+     * @return If name was found.
+     */
+    bool Find(const wxString& name, size_t& pos) const;
+
+
+// Private Types
+private:
+
+
+    /// Trigram key.
+    typedef wxUint64 Trigram;
+
+    /// Trigram and name position.
+    typedef std::pair<Trigram, size_t> Entry;
+
+
+// Private Operations
+private:
+
+
+    /**
+     * @brief Creates trigram key from three characters.
+     *
+     * @param str String.
+     * @param pos Position of the first character.
+     *
+     * @return
+     */
+    static Trigram MakeTrigram(const wxString& str, size_t pos);
+
+
+// Private Data Members
+private:
+
+
+    /// Indexed help list.
+    const CMake::HelpMap* m_data;
+
+    /// Sorted names.
+    wxArrayString m_names;
+
+    /// Trigrams sorted by key and position.
+    std::vector<Entry> m_trigrams;
+
+};
+
+/* ************************************************************************ */
+
+#endif // CMAKE_HELP_INDEX_H_
@@ -0,0 +1,144 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// Declaration
+#include "CMakeHelpList.h"
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+CMakeHelpList::CMakeHelpList(wxWindow* parent, wxWindowID id, const wxPoint& pos,
+                             const wxSize& size, long style)
+    : wxListCtrl(parent, id, pos, size, style)
+    , m_index(NULL)
+    , m_show(ShowIndex)
+{
+    // Only one column
+    InsertColumn(0, "");
+
+    Bind(wxEVT_SIZE, &CMakeHelpList::OnSize, this);
+}
+
+/* ************************************************************************ */
+
+wxString
+CMakeHelpList::GetName(long item) const
+{
+    CMakeHelpIndex::Item result;
+
+    if (!GetItem(item, result))
+        return wxEmptyString;
+
+    return result.first->GetName(result.second);
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeHelpList::GetItem(long item, CMakeHelpIndex::Item& result) const
+{
+    if (item < 0 || item >= GetItemCount())
+        return false;
+
+    switch (m_show) {
+    case ShowIndex:
+        result = CMakeHelpIndex::Item(m_index, item);
+        break;
+
+    case ShowPositions:
+        result = CMakeHelpIndex::Item(m_index, m_positions[item]);
+        break;
+
+    case ShowItems:
+        result = m_items[item];
+        break;
+    }
+
+    return result.first != NULL;
+}
+
+/* ************************************************************************ */
+
+void
+CMakeHelpList::SetIndex(const CMakeHelpIndex* index)
+{
+    m_index = index;
+    m_positions.clear();
+    m_items.clear();
+    m_show = ShowIndex;
+
+    SetItemCount(m_index ? m_index->GetCount() : 0);
+    Refresh();
+}
+
+/* ************************************************************************ */
+
+void
+CMakeHelpList::SetPositions(CMakeHelpIndex::Positions& positions)
+{
+    m_positions.swap(positions);
+    m_items.clear();
+    m_show = ShowPositions;
+
+    SetItemCount(m_index ? m_positions.size() : 0);
+    Refresh();
+}
+
+/* ************************************************************************ */
+
+void
+CMakeHelpList::SetItems(CMakeHelpIndex::Items& items)
+{
+    m_items.swap(items);
+    m_positions.clear();
+    m_show = ShowItems;
+
+    SetItemCount(m_items.size());
+    Refresh();
+}
+
+/* ************************************************************************ */
+
+wxString
+CMakeHelpList::OnGetItemText(long item, long column) const
+{
+    wxUnusedVar(column);
+
+    return GetName(item);
+}
+
+/* ************************************************************************ */
+
+void
+CMakeHelpList::OnSize(wxSizeEvent& event)
+{
+    event.Skip();
+
+    // Column fills whole width
+    SetColumnWidth(0, GetClientSize().GetWidth());
+}
+
+/* ************************************************************************ */
@@ -0,0 +1,174 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+#ifndef CMAKE_HELP_LIST_H_
+#define CMAKE_HELP_LIST_H_
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// wxWidgets
+#include <wx/listctrl.h>
+
+// CMakePlugin
+#include "CMakeHelpIndex.h"
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Virtual list of help item names.
+ *
+ * The list doesn't store names, they are read directly from help index
+ * so changing the shown index doesn't depend on number of names. The
+ * list can also show names from several indices.
+ */
+class CMakeHelpList : public wxListCtrl
+{
+
+// Public Ctors
+public:
+
+
+    /**
+     * @brief Constructor.
+     *
+     * Arguments match the code generated by wxCrafter.
+     *
+     * @param parent Parent window.
+     * @param id     Window ID.
+     * @param pos    Window position.
+     * @param size   Window size.
+     * @param style  List style (it must be a virtual report list).
+     */
+    explicit CMakeHelpList(wxWindow* parent, wxWindowID id = wxID_ANY,
+                           const wxPoint& pos = wxDefaultPosition,
+                           const wxSize& size = wxDefaultSize,
+                           long style = wxLC_REPORT | wxLC_VIRTUAL | wxLC_NO_HEADER | wxLC_SINGLE_SEL);
+
+
+// Public Accessors
+public:
+
+
+    /**
+     * @brief Returns name of the item.
+     *
+     * @param item Item number.
+     *
+     * @return
+     */
+    wxString GetName(long item) const;
+
+
+    /**
+     * @brief Returns index and position of the item.
+     *
+     * @param item   Item number.
+     * @param result Output index and position.
+     *
+     * @return If item is valid.
+     */
+    bool GetItem(long item, CMakeHelpIndex::Item& result) const;
+
+
+// Public Mutators
+public:
+
+
+    /**
+     * @brief Shows all names from index.
+     *
+     * @param index Index or NULL (nothing is shown).
+     */
+    void SetIndex(const CMakeHelpIndex* index);
+
+
+    /**
+     * @brief Shows only names at given positions of the current index.
+     *
+     * @param positions Positions, content is moved into the list.
+     */
+    void SetPositions(CMakeHelpIndex::Positions& positions);
+
+
+    /**
+     * @brief Shows names from any index.
+     *
+     * @param items Items, content is moved into the list.
+     */
+    void SetItems(CMakeHelpIndex::Items& items);
+
+
+// Protected Operations
+protected:
+
+
+    /**
+     * @brief Returns item text.
+     *
+     * @param item   Item number.
+     * @param column Column number.
+     *
+     * @return
+     */
+    virtual wxString OnGetItemText(long item, long column) const;
+
+
+// Private Events
+private:
+
+
+    /**
+     * @brief On list resize.
+     *
+     * @param event
+     */
+    void OnSize(wxSizeEvent& event);
+
+
+// Private Data Members
+private:
+
+
+    /// Shown index.
+    const CMakeHelpIndex* m_index;
+
+    /// Shown positions if the list is filtered.
+    CMakeHelpIndex::Positions m_positions;
+
+    /// Shown items from any index.
+    CMakeHelpIndex::Items m_items;
+
+    /// What is shown.
+    enum {
+        ShowIndex,
+        ShowPositions,
+        ShowItems
+    } m_show;
+
+};
+
+/* ************************************************************************ */
+
+#endif // CMAKE_HELP_LIST_H_
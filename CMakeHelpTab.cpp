@@ -46,6 +46,7 @@
 wxDEFINE_EVENT(EVT_THREAD_START, wxThreadEvent);
 wxDEFINE_EVENT(EVT_THREAD_UPDATE, wxThreadEvent);
 wxDEFINE_EVENT(EVT_THREAD_DONE, wxThreadEvent);
+wxDEFINE_EVENT(EVT_THREAD_PAGE, wxThreadEvent);
 
 /* ************************************************************************ */
 /* CLASSES                                                                  */
@@ -54,7 +55,10 @@ wxDEFINE_EVENT(EVT_THREAD_DONE, wxThreadEvent);
 CMakeHelpTab::CMakeHelpTab(wxWindow* parent, CMakePlugin* plugin)
     : CMakeHelpTabBase(parent)
     , m_plugin(plugin)
+    , m_data(NULL)
+    , m_index(NULL)
     , m_force(false)
+    , m_pageList(NULL)
 {
     wxASSERT(plugin);
     wxASSERT(m_gaugeLoad->GetRange() == 100); // Must be 100
@@ -63,6 +67,10 @@ CMakeHelpTab::CMakeHelpTab(wxWindow* parent, CMakePlugin* plugin)
     Bind(EVT_THREAD_START, &CMakeHelpTab::OnThreadStart, this);
     Bind(EVT_THREAD_UPDATE, &CMakeHelpTab::OnThreadUpdate, this);
     Bind(EVT_THREAD_DONE, &CMakeHelpTab::OnThreadDone, this);
+    Bind(EVT_THREAD_PAGE, &CMakeHelpTab::OnThreadPage, this);
+
+    // Full-text search is started by '?', fuzzy search by '~'
+    m_searchCtrlFilter->SetDescriptiveText(_("Filter (?text searches help pages, ~text all names)"));
 
     // Initial load
     LoadData();
@@ -79,7 +87,7 @@ CMakeHelpTab::OnChangeTopic(wxCommandEvent& event)
 /* ************************************************************************ */
 
 void
-CMakeHelpTab::OnInsert(wxCommandEvent& event)
+CMakeHelpTab::OnItemActivated(wxListEvent& event)
 {
     IManager* manager = m_plugin->GetManager();
     wxASSERT(manager);
@@ -90,7 +98,7 @@ CMakeHelpTab::OnInsert(wxCommandEvent& event)
         return;
 
     // Insert value
-    editor->InsertText(editor->GetCurrentPosition(), m_listBoxList->GetString(event.GetInt()));
+    editor->InsertText(editor->GetCurrentPosition(), m_listCtrlList->GetName(event.GetIndex()));
 }
 
 /* ************************************************************************ */
@@ -116,22 +124,33 @@ CMakeHelpTab::OnSearchCancel(wxCommandEvent& event)
 /* ************************************************************************ */
 
 void
-CMakeHelpTab::OnSelect(wxCommandEvent& event)
+CMakeHelpTab::OnItemSelected(wxListEvent& event)
 {
     wxASSERT(!GetThread() || !GetThread()->IsRunning());
-    wxASSERT(m_data);
 
-    // Get selected name
-    const wxString name = m_listBoxList->GetString(event.GetInt());
+    // Get selected item, it can be from any topic
+    CMakeHelpIndex::Item item;
+    if (!m_listCtrlList->GetItem(event.GetIndex(), item))
+        return;
 
-    // Find name in the data
-    std::map<wxString, wxString>::const_iterator it = m_data->find(name);
+    const CMakeHelpIndex* index = item.first;
+    wxASSERT(index->GetData());
+
+    // Find page, in lazy mode it's loaded on demand
+    CMake* cmake = m_plugin->GetCMake();
+    wxASSERT(cmake);
+    const wxString name = index->GetName(item.second);
+    const wxString page = cmake->GetHelp(*index->GetData(), name);
 
     // Data found
-    if (it != m_data->end()) {
+    if (!page.IsEmpty()) {
         // Show required data
-        m_htmlWinText->SetPage(it->second);
+        m_htmlWinText->SetPage(page);
+        return;
     }
+
+    // Page is produced by cmake in the background thread
+    LoadPage(*index->GetData(), name);
 }
 
 /* ************************************************************************ */
@@ -155,18 +174,10 @@ CMakeHelpTab::OnReload(wxCommandEvent& event)
 void
 CMakeHelpTab::ListAll()
 {
-    // Remove old data
-    m_listBoxList->Clear();
     m_htmlWinText->SetPage("");
 
-    if (!m_data)
-        return;
-
-    // Foreach data and store names into list
-    for (std::map<wxString, wxString>::const_iterator it = m_data->begin(),
-         ite = m_data->end(); it != ite; ++it) {
-        m_listBoxList->Append(it->first);
-    }
+    // Show all names from index
+    m_listCtrlList->SetIndex(m_index);
 }
 
 /* ************************************************************************ */
@@ -174,22 +185,40 @@ CMakeHelpTab::ListAll()
 void
 CMakeHelpTab::ListFiltered(const wxString& search)
 {
-    const wxString searchMatches = "*" + search + "*";
-
-    // Remove old data
-    m_listBoxList->Clear();
     m_htmlWinText->SetPage("");
 
-    if (!m_data)
+    CMakeHelpIndex::Positions positions;
+
+    if (!m_data || !m_index) {
+        m_listCtrlList->SetPositions(positions);
         return;
+    }
 
-    // Foreach data and store names into list
-    for (std::map<wxString, wxString>::const_iterator it = m_data->begin(),
-         ite = m_data->end(); it != ite; ++it) {
-        // Store only that starts with given string
-        if (it->first.Matches(searchMatches))
-            m_listBoxList->Append(it->first);
+    // Fuzzy search in all topics
+    wxString text;
+    if (search.StartsWith("~", &text)) {
+        CMakeHelpIndex::Items items;
+        m_fuzzy.Match(text, items);
+        m_listCtrlList->SetItems(items);
+        return;
     }
+
+    // Full-text search in help pages
+    if (search.StartsWith("?", &text)) {
+        const CMake::SearchResult hits = m_plugin->GetCMake()->Search(text, m_data);
+
+        // Hits are ordered by relevance
+        for (CMake::SearchResult::const_iterator it = hits.begin(), ite = hits.end(); it != ite; ++it) {
+            size_t pos;
+            if (m_index->Find(it->name, pos))
+                positions.push_back(pos);
+        }
+    } else {
+        // Find names that contain given string
+        m_index->Filter(search, positions);
+    }
+
+    m_listCtrlList->SetPositions(positions);
 }
 
 /* ************************************************************************ */
@@ -261,6 +290,21 @@ CMakeHelpTab::OnThreadDone(wxThreadEvent& event)
 
 /* ************************************************************************ */
 
+void
+CMakeHelpTab::OnThreadPage(wxThreadEvent& event)
+{
+    wxASSERT(m_pageList);
+
+    // Keep page for the next selection
+    m_plugin->GetCMake()->AddHelp(*m_pageList, m_pageName, event.GetString());
+    m_pageList = NULL;
+
+    // Show loaded page or remove the placeholder
+    m_htmlWinText->SetPage(event.GetString());
+}
+
+/* ************************************************************************ */
+
 void
 CMakeHelpTab::OnClose(wxCloseEvent& event)
 {
@@ -290,6 +334,9 @@ CMakeHelpTab::ShowTopic(int topic)
     const CMake* cmake = m_plugin->GetCMake();
     wxASSERT(cmake);
 
+    // Topics have the same order as indices
+    m_index = (topic >= 0 && topic < 4) ? &m_indices[topic] : NULL;
+
     switch (topic) {
     default:
         m_data = NULL;
@@ -328,8 +375,18 @@ CMakeHelpTab::PublishData()
     if (GetThread() && GetThread()->IsRunning())
         return;
 
+    const CMake* cmake = m_plugin->GetCMake();
+    wxASSERT(cmake);
+
     // Set CMake version
-    m_staticTextVersionValue->SetLabel(m_plugin->GetCMake()->GetVersion());
+    m_staticTextVersionValue->SetLabel(cmake->GetVersion());
+
+    // Build name indices (same order as topics)
+    m_indices[0].Build(cmake->GetModules());
+    m_indices[1].Build(cmake->GetCommands());
+    m_indices[2].Build(cmake->GetVariables());
+    m_indices[3].Build(cmake->GetProperties());
+    m_fuzzy.Build(m_indices, 4);
 
     // Show the first topic
     m_radioBoxTopic->SetSelection(0);
@@ -344,8 +401,15 @@ CMakeHelpTab::Entry()
     CMake* cmake = m_plugin->GetCMake();
     wxASSERT(cmake);
 
-    // Load data
-    cmake->LoadData(m_force, this);
+    // Load single help page, lists are not changed
+    if (m_pageList) {
+        wxThreadEvent event(EVT_THREAD_PAGE);
+        event.SetString(cmake->LoadHelp(*m_pageList, m_pageName));
+        AddPendingEvent(event);
+    } else {
+        // Load data
+        cmake->LoadData(m_force, this);
+    }
 
     return static_cast<wxThread::ExitCode>(0);
 }
@@ -367,11 +431,42 @@ CMakeHelpTab::LoadData(bool force)
     }
 
     m_force = force;
+    m_pageList = NULL;
+
+    StartThread();
+}
+
+/* ************************************************************************ */
 
+void
+CMakeHelpTab::LoadPage(const std::map<wxString, wxString>& list, const wxString& name)
+{
+    // Thread is busy
+    if (GetThread() && GetThread()->IsRunning()) {
+        return;
+    }
+
+    m_pageList = &list;
+    m_pageName = name;
+
+    // Placeholder until the page is loaded
+    m_htmlWinText->SetPage(_("<i>Loading...</i>"));
+
+    if (!StartThread()) {
+        m_pageList = NULL;
+        m_htmlWinText->SetPage("");
+    }
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeHelpTab::StartThread()
+{
     // Create a new joinable thread
     if (CreateThread(wxTHREAD_JOINABLE) != wxTHREAD_NO_ERROR) {
         CL_ERROR("Could not create the worker thread!");
-        return;
+        return false;
     }
 
     // For sure :)
@@ -380,8 +475,10 @@ CMakeHelpTab::LoadData(bool force)
     // Run the thread
     if (GetThread()->Run() != wxTHREAD_NO_ERROR) {
         CL_ERROR("Could not run the worker thread!");
-        return;
+        return false;
     }
+
+    return true;
 }
 
 /* ************************************************************************ */
@@ -34,6 +34,9 @@
 // UI
 #include "CMakePluginUi.h"
 #include "CMake.h"
+#include "CMakeHelpIndex.h"
+#include "CMakeHelpList.h"
+#include "CMakeHelpFuzzy.h"
 
 /* ************************************************************************ */
 /* FORWARD DECLARATIONS                                                     */
@@ -78,35 +81,35 @@ protected:
 
 
     /**
-     * @brief On item insert into editor.
+     * @brief On item search.
      *
      * @param event
      */
-    virtual void OnInsert(wxCommandEvent& event);
+    virtual void OnSearch(wxCommandEvent& event);
 
 
     /**
-     * @brief On item search.
+     * @brief On item search cancel.
      *
      * @param event
      */
-    virtual void OnSearch(wxCommandEvent& event);
+    virtual void OnSearchCancel(wxCommandEvent& event);
 
 
     /**
-     * @brief On item search cancel.
+     * @brief On item select.
      *
      * @param event
      */
-    virtual void OnSearchCancel(wxCommandEvent& event);
+    virtual void OnItemSelected(wxListEvent& event);
 
 
     /**
-     * @brief On item select.
+     * @brief On item activation (insert into editor).
      *
      * @param event
      */
-    virtual void OnSelect(wxCommandEvent& event);
+    virtual void OnItemActivated(wxListEvent& event);
 
 
     /**
@@ -157,6 +160,14 @@ protected:
     void OnThreadDone(wxThreadEvent& event);
 
 
+    /**
+     * @brief Shows help page loaded by the background thread.
+     *
+     * @param event Event with the page.
+     */
+    void OnThreadPage(wxThreadEvent& event);
+
+
     /**
      * @brief On tab close.
      *
@@ -252,6 +263,17 @@ protected:
     void LoadData(bool force = false);
 
 
+    /**
+     * @brief Loads help page by cmake in the background thread.
+     *
+     * Placeholder is shown until the page is loaded.
+     *
+     * @param list List that contains the item.
+     * @param name Item name.
+     */
+    void LoadPage(const std::map<wxString, wxString>& list, const wxString& name);
+
+
 // Private Operations
 private:
 
@@ -270,6 +292,14 @@ private:
     void ListFiltered(const wxString& search);
 
 
+    /**
+     * @brief Creates and runs the background thread.
+     *
+     * @return If thread is running.
+     */
+    bool StartThread();
+
+
 // Private Data Members
 private:
 
@@ -280,11 +310,26 @@ private:
     /// Current topic data.
     const std::map<wxString, wxString>* m_data;
 
+    /// Name indices for all topics.
+    CMakeHelpIndex m_indices[4];
+
+    /// Current topic name index.
+    const CMakeHelpIndex* m_index;
+
+    /// Fuzzy matcher of names from all topics.
+    CMakeHelpFuzzy m_fuzzy;
+
     /// Temporary variable.
     bool m_force;
 
     /// Current progress state.
     int m_progress;
+
+    /// List of the page loaded by the thread (NULL if data are loaded).
+    const std::map<wxString, wxString>* m_pageList;
+
+    /// Name of the item whose page is loaded by the thread.
+    wxString m_pageName;
 };
 
 /* ************************************************************************ */
@@ -0,0 +1,353 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// Declaration
+#include "CMakeListsGenerator.h"
+
+// C++
+#include <algorithm>
+
+// wxWidgets
+#include <wx/tokenzr.h>
+#include <wx/thread.h>
+
+// CMakePlugin
+#include "CMakeCoreHost.h"
+
+/* ************************************************************************ */
+/* STRUCTURES                                                               */
+/* ************************************************************************ */
+
+/**
+ * @brief State shared by generator workers.
+ */
+struct GenerateJobs
+{
+    /// Generated projects.
+    const wxVector<CMakeListsGenerator::ProjectFile>& projects;
+
+    /// Guards the members below.
+    wxMutex mutex;
+
+    /// Index of the next project.
+    size_t next;
+
+    /// Number of changed files.
+    size_t changed;
+
+
+    /**
+     * @brief Constructor.
+     *
+     * @param projects Generated projects.
+     */
+    explicit GenerateJobs(const wxVector<CMakeListsGenerator::ProjectFile>& projects)
+        : projects(projects), next(0), changed(0)
+    {}
+};
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Worker thread that generates projects one by one.
+ */
+class GenerateWorker : public wxThread
+{
+public:
+
+
+    /**
+     * @brief Constructor.
+     *
+     * @param jobs Shared jobs.
+     */
+    explicit GenerateWorker(GenerateJobs& jobs)
+        : wxThread(wxTHREAD_JOINABLE)
+        , m_jobs(jobs)
+    {}
+
+
+    /**
+     * @brief Generates projects until there is nothing to do.
+     */
+    void Process()
+    {
+        while (true) {
+            size_t index;
+
+            // Take next project
+            {
+                wxMutexLocker lock(m_jobs.mutex);
+
+                if (m_jobs.next >= m_jobs.projects.size())
+                    break;
+
+                index = m_jobs.next++;
+            }
+
+            const CMakeListsGenerator::ProjectFile& project = m_jobs.projects[index];
+            CMakeFileWriter output;
+
+            if (!output.Open(project.filename))
+                continue;
+
+            CMakeListsGenerator::GenerateProject(project.data, output);
+
+            if (output.Commit() && output.IsChanged()) {
+                wxMutexLocker lock(m_jobs.mutex);
+                m_jobs.changed++;
+            }
+        }
+    }
+
+
+protected:
+
+
+    /**
+     * @brief Thread entry.
+     *
+     * @return Exit code.
+     */
+    virtual ExitCode Entry()
+    {
+        Process();
+        return static_cast<ExitCode>(0);
+    }
+
+
+private:
+
+    /// Shared jobs.
+    GenerateJobs& m_jobs;
+};
+
+/* ************************************************************************ */
+
+void
+CMakeListsGenerator::GenerateWorkspace(const WorkspaceData& workspace, CMakeFileWriter& output)
+{
+    // Print project name
+    output << "# Workspace name\n";
+    output << "project(" << workspace.name << ")\n\n";
+
+    // Environment variables
+    {
+        wxString variables = workspace.environment;
+        variables.Trim().Trim(false);
+
+        if (!variables.IsEmpty()) {
+            // Split into a list of pairs
+            const wxArrayString list = wxStringTokenize(variables, "\n;");
+
+            for (wxArrayString::const_iterator it = list.begin(),
+                ite = list.end(); it != ite; ++it) {
+                // Split into name, value pair
+                const wxArrayString pair = wxSplit(*it, '=');
+
+                const wxString& name = pair[0];
+                const wxString value = (pair.GetCount() >= 2) ? pair[1] : "";
+
+                // Set environment variable
+                output << "set(" << name << " \"" << value << "\")\n";
+            }
+
+            output << "\n";
+        }
+    }
+
+    output << "# Projects\n";
+
+    for (wxArrayString::const_iterator it = workspace.subdirectories.begin(),
+        ite = workspace.subdirectories.end(); it != ite; ++it) {
+        output << "add_subdirectory(" << *it << ")\n";
+    }
+}
+
+/* ************************************************************************ */
+
+void
+CMakeListsGenerator::GenerateProject(const ProjectData& project, CMakeFileWriter& output)
+{
+    // TODO custom version
+    output << "cmake_minimum_required(VERSION 2.6.2)\n\n";
+
+    // Print project name
+    output << "project(" << project.name << ")\n\n";
+
+    // Add include directories
+    {
+        wxString includes = project.includePaths;
+
+        // Trim all whitespaces
+        includes.Trim().Trim(false);
+
+        // Ignore empty include paths
+        if (!includes.IsEmpty()) {
+            // Separators
+            includes.Replace(";", "\n    ");
+            // Replace Windows backslashes
+            includes.Replace("\\", "/");
+
+            output << "include_directories(\n    " << includes << "\n)\n\n";
+        }
+    }
+
+    // Add preprocessor definitions
+    {
+        wxString defines = project.definitions;
+
+        defines.Trim().Trim(false);
+        defines.Replace(";", "\n    -D");
+
+        if (!defines.IsEmpty())
+        {
+            output << "add_definitions(\n    -D" << defines << "\n)\n\n";
+        }
+    }
+
+    // Add compiler options
+    {
+        wxString buildOpts = project.compileOptions;
+
+        buildOpts.Trim().Trim(false);
+        buildOpts.Replace(";", " ");
+
+        if (!buildOpts.IsEmpty()) {
+            output << "set(CMAKE_CXXFLAGS \"${CMAKE_CXXFLAGS} " << buildOpts << "\")\n\n";
+        }
+    }
+
+    // Add linker options
+    {
+        wxString links = project.linkOptions;
+
+        links.Trim().Trim(false);
+        links.Replace(";", " ");
+
+        if (!links.IsEmpty()) {
+            output << "# Linker options\n";
+            output << "set(CMAKE_LDFLAGS \"${CMAKE_LDFLAGS} " << links << "\")\n\n";
+        }
+    }
+
+    // Add libraries paths
+    {
+        // Get list of library paths
+        wxArrayString lib_paths_list = wxStringTokenize(project.libraryPaths, ";", wxTOKEN_STRTOK);
+
+        wxString lib_paths;
+
+        // Append modified values
+        for (size_t i = 0; i < lib_paths_list.GetCount(); ++i) {
+            lib_paths << project.libraryPathSwitch << "\\\"" << lib_paths_list.Item(i) << "\\\" ";
+        }
+
+        output << "# Library path\n";
+        output << "set(CMAKE_LDFLAGS \"${CMAKE_LDFLAGS} " << lib_paths << "\")\n\n";
+    }
+
+    // Write sources
+    {
+        output << "set(SRCS\n";
+
+        for (wxArrayString::const_iterator it = project.sources.begin(),
+            ite = project.sources.end(); it != ite; ++it) {
+            // Store file name into SRCS
+            output << "    " << *it << "\n";
+        }
+
+        output << ")\n\n";
+    }
+
+    // Project type
+    {
+        if (project.type == TargetExecutable) {
+            output << "add_executable(" << project.name << " ${SRCS})\n\n";
+        } else if (project.type == TargetSharedLibrary) {
+            output << "add_library(" << project.name << " SHARED ${SRCS})\n\n";
+        } else {
+            output << "add_library(" << project.name << " ${SRCS})\n\n";
+        }
+    }
+
+    // Add link libraries
+    {
+        wxString libs = project.libraries;
+
+        libs.Trim().Trim(false);
+
+        if (!libs.IsEmpty()) {
+            libs.Replace(";", "\n    ");
+            output << "target_link_libraries(" <<
+                project.name << "\n    " <<
+                libs << "\n)\n\n";
+        }
+    }
+}
+
+/* ************************************************************************ */
+
+size_t
+CMakeListsGenerator::GenerateProjects(const wxVector<ProjectFile>& projects)
+{
+    GenerateJobs jobs(projects);
+
+    // One worker per CPU, but not more than projects
+    const size_t count = std::min(static_cast<size_t>(std::max(wxThread::GetCPUCount(), 1)), projects.size());
+
+    wxVector<GenerateWorker*> workers;
+
+    // Start workers
+    for (size_t i = 0; i < count; ++i) {
+        GenerateWorker* worker = new GenerateWorker(jobs);
+
+        if (worker->Run() != wxTHREAD_NO_ERROR) {
+            CMAKE_ERROR("CMake: unable to run generator worker");
+            delete worker;
+            break;
+        }
+
+        workers.push_back(worker);
+    }
+
+    // Unable to run any worker, generate in the current thread
+    if (workers.empty()) {
+        GenerateWorker worker(jobs);
+        worker.Process();
+    }
+
+    // Join workers
+    for (wxVector<GenerateWorker*>::iterator it = workers.begin(), ite = workers.end(); it != ite; ++it) {
+        (*it)->Wait();
+        delete *it;
+    }
+
+    return jobs.changed;
+}
+
+/* ************************************************************************ */
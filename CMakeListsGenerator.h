@@ -0,0 +1,196 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+#ifndef CMAKE_LISTS_GENERATOR_H_
+#define CMAKE_LISTS_GENERATOR_H_
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// wxWidgets
+#include <wx/string.h>
+#include <wx/arrstr.h>
+#include <wx/vector.h>
+#include <wx/filename.h>
+
+// CMakePlugin
+#include "CMakeFileWriter.h"
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Generates content of CMakeLists.txt files.
+ *
+ * Generator works only with plain data, it doesn't know anything about
+ * CodeLite workspace and projects, so it can be used without the IDE.
+ * Data are collected by CMakeGenerator. Content is streamed into
+ * the writer section by section, it's never kept whole in memory.
+ */
+class CMakeListsGenerator
+{
+
+// Public Enums
+public:
+
+
+    /**
+     * @brief Type of project target.
+     */
+    enum TargetType
+    {
+        /// add_executable()
+        TargetExecutable = 0,
+
+        /// add_library(SHARED)
+        TargetSharedLibrary,
+
+        /// add_library()
+        TargetStaticLibrary
+    };
+
+
+// Public Structures
+public:
+
+
+    /**
+     * @brief Workspace data.
+     */
+    struct WorkspaceData
+    {
+        /// Workspace name.
+        wxString name;
+
+        /// Environment variables (NAME=value separated by new lines or ';').
+        wxString environment;
+
+        /// Project directories with CMakeLists.txt (relative to workspace).
+        wxArrayString subdirectories;
+    };
+
+
+    /**
+     * @brief Project data.
+     *
+     * Lists are separated by ';' as in CodeLite build configuration.
+     */
+    struct ProjectData
+    {
+        /// Project name.
+        wxString name;
+
+        /// Target type.
+        TargetType type;
+
+        /// Include paths.
+        wxString includePaths;
+
+        /// Preprocessor definitions.
+        wxString definitions;
+
+        /// Compiler options.
+        wxString compileOptions;
+
+        /// Linker options.
+        wxString linkOptions;
+
+        /// Library paths.
+        wxString libraryPaths;
+
+        /// Library path switch (e.g. -L).
+        wxString libraryPathSwitch;
+
+        /// Libraries.
+        wxString libraries;
+
+        /// Source files (relative to project, Unix separators).
+        wxArrayString sources;
+
+
+        /**
+         * @brief Constructor.
+         */
+        ProjectData()
+            : type(TargetExecutable)
+            , libraryPathSwitch("-L")
+        {}
+    };
+
+
+    /**
+     * @brief Project data with its output file.
+     */
+    struct ProjectFile
+    {
+        /// Output CMakeLists.txt.
+        wxFileName filename;
+
+        /// Project data.
+        ProjectData data;
+    };
+
+
+// Public Operations
+public:
+
+
+    /**
+     * @brief Generates workspace CMakeLists.txt.
+     *
+     * File adds projects as subdirectories.
+     *
+     * @param workspace Workspace data.
+     * @param output    Output writer.
+     */
+    static void GenerateWorkspace(const WorkspaceData& workspace,
+                                  CMakeFileWriter& output);
+
+
+    /**
+     * @brief Generates project CMakeLists.txt.
+     *
+     * @param project Project data.
+     * @param output  Output writer.
+     */
+    static void GenerateProject(const ProjectData& project,
+                                CMakeFileWriter& output);
+
+
+    /**
+     * @brief Generates CMakeLists.txt files of projects.
+     *
+     * Files are generated and written by a pool of worker threads.
+     * Files with unchanged content are not rewritten.
+     *
+     * @param projects Projects with output files.
+     *
+     * @return Number of changed files.
+     */
+    static size_t GenerateProjects(const wxVector<ProjectFile>& projects);
+
+};
+
+/* ************************************************************************ */
+
+#endif // CMAKE_LISTS_GENERATOR_H_
@@ -0,0 +1,166 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// Declaration
+#include "CMakeMappedFile.h"
+
+// System
+#ifdef __WXMSW__
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+CMakeMappedFile::CMakeMappedFile()
+    : m_opened(false)
+    , m_data(NULL)
+    , m_size(0)
+#ifdef __WXMSW__
+    , m_mapping(NULL)
+#endif
+{
+    // Nothing to do
+}
+
+/* ************************************************************************ */
+
+CMakeMappedFile::~CMakeMappedFile()
+{
+    Close();
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeMappedFile::Open(const wxString& path)
+{
+    Close();
+
+#ifdef __WXMSW__
+    HANDLE file = ::CreateFileW(path.wc_str(), GENERIC_READ, FILE_SHARE_READ,
+                                NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file, &size)) {
+        ::CloseHandle(file);
+        return false;
+    }
+
+    m_size = static_cast<size_t>(size.QuadPart);
+
+    // Empty file cannot be mapped
+    if (m_size) {
+        m_mapping = ::CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+        if (m_mapping) {
+            m_data = static_cast<const char*>(
+                ::MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0)
+            );
+        }
+
+        if (!m_data) {
+            if (m_mapping)
+                ::CloseHandle(m_mapping);
+
+            m_mapping = NULL;
+            m_size = 0;
+            ::CloseHandle(file);
+            return false;
+        }
+    }
+
+    // Mapping keeps the file open
+    ::CloseHandle(file);
+#else
+    const int fd = ::open(path.fn_str(), O_RDONLY);
+
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    m_size = static_cast<size_t>(st.st_size);
+
+    // Empty file cannot be mapped
+    if (m_size) {
+        void* data = ::mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data == MAP_FAILED) {
+            m_size = 0;
+            ::close(fd);
+            return false;
+        }
+
+        // File is read sequentially
+        ::madvise(data, m_size, MADV_SEQUENTIAL);
+
+        m_data = static_cast<const char*>(data);
+    }
+
+    // Mapping keeps the file open
+    ::close(fd);
+#endif
+
+    m_opened = true;
+
+    return true;
+}
+
+/* ************************************************************************ */
+
+void
+CMakeMappedFile::Close()
+{
+    if (m_data) {
+#ifdef __WXMSW__
+        ::UnmapViewOfFile(m_data);
+        ::CloseHandle(m_mapping);
+        m_mapping = NULL;
+#else
+        ::munmap(const_cast<char*>(m_data), m_size);
+#endif
+    }
+
+    m_opened = false;
+    m_data = NULL;
+    m_size = 0;
+}
+
+/* ************************************************************************ */
@@ -0,0 +1,153 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+#ifndef CMAKE_MAPPED_FILE_H_
+#define CMAKE_MAPPED_FILE_H_
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// C++
+#include <cstddef>
+
+// wxWidgets
+#include <wx/string.h>
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Read-only file mapped into memory.
+ *
+ * File content is accessible as raw bytes without reading it into
+ * a buffer. Mapping is released by Close() or by destructor.
+ */
+class CMakeMappedFile
+{
+
+// Public Ctors & Dtors
+public:
+
+
+    /**
+     * @brief Constructor.
+     */
+    CMakeMappedFile();
+
+
+    /**
+     * @brief Destructor.
+     */
+    ~CMakeMappedFile();
+
+
+// Public Accessors
+public:
+
+
+    /**
+     * @brief Checks if file is opened.
+     *
+     * @return
+     */
+    bool IsOpened() const {
+        return m_opened;
+    }
+
+
+    /**
+     * @brief Returns file content.
+     *
+     * @return Pointer to the first byte or NULL for an empty file.
+     */
+    const char* GetData() const {
+        return m_data;
+    }
+
+
+    /**
+     * @brief Returns file size in bytes.
+     *
+     * @return
+     */
+    size_t GetSize() const {
+        return m_size;
+    }
+
+
+// Public Operations
+public:
+
+
+    /**
+     * @brief Maps file into memory.
+     *
+     * Previously opened file is closed.
+     *
+     * @param path Path to the file.
+     *
+     * @return If file was mapped.
+     */
+    bool Open(const wxString& path);
+
+
+    /**
+     * @brief Unmaps the file.
+     */
+    void Close();
+
+
+// Private Ctors
+private:
+
+
+    /// Not copyable.
+    CMakeMappedFile(const CMakeMappedFile&);
+
+    /// Not copyable.
+    CMakeMappedFile& operator=(const CMakeMappedFile&);
+
+
+// Private Data Members
+private:
+
+
+    /// If file is opened.
+    bool m_opened;
+
+    /// Mapped content.
+    const char* m_data;
+
+    /// Content size.
+    size_t m_size;
+
+#ifdef __WXMSW__
+    /// File mapping handle.
+    void* m_mapping;
+#endif
+
+};
+
+/* ************************************************************************ */
+
+#endif // CMAKE_MAPPED_FILE_H_
@@ -0,0 +1,710 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// Declaration
+#include "CMakeParseCache.h"
+
+// C++
+#include <cstring>
+#include <algorithm>
+
+// wxWidgets
+#include <wx/buffer.h>
+#include <wx/datetime.h>
+#include <wx/wxsqlite3.h>
+
+// CMakePlugin
+#include "CMakeCoreHost.h"
+
+/* ************************************************************************ */
+/* VARIABLES                                                                */
+/* ************************************************************************ */
+
+/// Version of the database schema and of the serialized data.
+static const int CACHE_VERSION = 5;
+
+/* ************************************************************************ */
+/* STRUCTURES                                                               */
+/* ************************************************************************ */
+
+/**
+ * @brief Table of symbols stored with one entry.
+ */
+struct SymbolTable
+{
+    /// Stored symbols.
+    wxVector<CMakeSymbols::Id> ids;
+
+    /// Map of symbol to index in stored symbols.
+    std::map<CMakeSymbols::Id, size_t> indices;
+
+
+    /**
+     * @brief Adds symbol into the table.
+     *
+     * @param id Symbol ID.
+     */
+    void Add(CMakeSymbols::Id id) {
+        if (indices.insert(std::make_pair(id, ids.size())).second)
+            ids.push_back(id);
+    }
+};
+
+/**
+ * @brief Checks if the span lies within the data.
+ *
+ * @param pos    Span position.
+ * @param length Span length.
+ * @param size   Data size.
+ *
+ * @return
+ */
+static bool IsInside(wxUint64 pos, wxUint64 length, wxUint64 size)
+{
+    return pos <= size && length <= size - pos;
+}
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Writes values into binary buffer.
+ */
+class CacheWriter
+{
+public:
+
+
+    /**
+     * @brief Writes an integer.
+     *
+     * @param value
+     */
+    void WriteInt(wxUint64 value) {
+        m_buffer.AppendData(&value, sizeof(value));
+    }
+
+
+    /**
+     * @brief Writes a string as UTF-8.
+     *
+     * @param value
+     */
+    void WriteString(const wxString& value) {
+        const wxScopedCharBuffer utf8 = value.utf8_str();
+        WriteInt(utf8.length());
+        m_buffer.AppendData(utf8.data(), utf8.length());
+    }
+
+
+    /**
+     * @brief Returns written data.
+     *
+     * @return
+     */
+    const wxMemoryBuffer& GetBuffer() const {
+        return m_buffer;
+    }
+
+
+private:
+
+    /// Output buffer.
+    wxMemoryBuffer m_buffer;
+};
+
+/* ************************************************************************ */
+
+/**
+ * @brief Reads values from binary buffer.
+ */
+class CacheReader
+{
+public:
+
+
+    /**
+     * @brief Constructor.
+     *
+     * @param data Data.
+     * @param size Data size.
+     */
+    CacheReader(const char* data, size_t size)
+        : m_current(data), m_end(data + size), m_ok(true)
+    {}
+
+
+    /**
+     * @brief Checks if all reads were successful.
+     *
+     * @return
+     */
+    bool IsOk() const {
+        return m_ok;
+    }
+
+
+    /**
+     * @brief Reads an integer.
+     *
+     * @return Value or 0 on error.
+     */
+    wxUint64 ReadInt() {
+        wxUint64 value = 0;
+
+        if (Check(sizeof(value))) {
+            memcpy(&value, m_current, sizeof(value));
+            m_current += sizeof(value);
+        }
+
+        return value;
+    }
+
+
+    /**
+     * @brief Reads a number of items.
+     *
+     * Each item takes at least itemSize bytes, so the count can't be
+     * greater than the remaining data allows.
+     *
+     * @param itemSize Minimum size of one item.
+     *
+     * @return Count or 0 on error.
+     */
+    size_t ReadCount(size_t itemSize) {
+        const wxUint64 count = ReadInt();
+
+        if (count > static_cast<wxUint64>(m_end - m_current) / itemSize) {
+            m_ok = false;
+            return 0;
+        }
+
+        return count;
+    }
+
+
+    /**
+     * @brief Reads a string.
+     *
+     * @return Value or empty string on error.
+     */
+    wxString ReadString() {
+        const wxUint64 length = ReadInt();
+
+        if (!Check(length))
+            return wxString();
+
+        const wxString value = wxString::FromUTF8(m_current, length);
+        m_current += length;
+        return value;
+    }
+
+
+    /**
+     * @brief Reads a symbol stored as index into the entry symbols.
+     *
+     * @param symbols Entry symbols.
+     *
+     * @return Symbol ID.
+     */
+    CMakeSymbols::Id ReadSymbol(const wxVector<CMakeSymbols::Id>& symbols) {
+        const wxUint64 index = ReadInt();
+
+        if (index >= symbols.size()) {
+            m_ok = false;
+            return CMakeSymbols::InvalidId;
+        }
+
+        return symbols[index];
+    }
+
+
+private:
+
+
+    /**
+     * @brief Checks if there is enough data.
+     *
+     * @param size Required size.
+     *
+     * @return
+     */
+    bool Check(wxUint64 size) {
+        if (static_cast<wxUint64>(m_end - m_current) < size)
+            m_ok = false;
+
+        return m_ok;
+    }
+
+
+private:
+
+    /// Current position.
+    const char* m_current;
+
+    /// End of data.
+    const char* m_end;
+
+    /// No error occured.
+    bool m_ok;
+};
+
+/* ************************************************************************ */
+
+CMakeParseCache::CMakeParseCache()
+{
+    // Nothing to do
+}
+
+/* ************************************************************************ */
+
+size_t
+CMakeParseCache::GetCount() const
+{
+    wxMutexLocker lock(m_mutex);
+    return m_entries.size();
+}
+
+/* ************************************************************************ */
+
+void
+CMakeParseCache::Clear()
+{
+    wxMutexLocker lock(m_mutex);
+    m_entries.clear();
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeParseCache::Restore(CMakeParser& parser, wxLongLong_t mtime, wxUint64 size)
+{
+    // File was changed while it was mapped
+    if (size != parser.m_size)
+        return false;
+
+    const wxString path = parser.m_filename.GetFullPath();
+
+    wxUint64 hash;
+
+    // Find entry
+    {
+        wxMutexLocker lock(m_mutex);
+        std::map<wxString, Entry>::const_iterator it = m_entries.find(path);
+
+        if (it == m_entries.end() || it->second.size != size)
+            return false;
+
+        // File wasn't touched
+        if (it->second.mtime == mtime) {
+            Restore(it->second, parser);
+            return true;
+        }
+
+        hash = it->second.hash;
+    }
+
+    // File was touched, compare content (without lock)
+    if (Hash(parser.m_data, parser.m_size) != hash)
+        return false;
+
+    wxMutexLocker lock(m_mutex);
+    std::map<wxString, Entry>::iterator it = m_entries.find(path);
+
+    // Entry was changed meanwhile
+    if (it == m_entries.end() || it->second.hash != hash)
+        return false;
+
+    it->second.mtime = mtime;
+    it->second.dirty = true;
+
+    Restore(it->second, parser);
+
+    return true;
+}
+
+/* ************************************************************************ */
+
+void
+CMakeParseCache::Store(const CMakeParser& parser, wxLongLong_t mtime, wxUint64 size)
+{
+    // File was changed while it was mapped, the stored time could match
+    // content that wasn't parsed
+    if (size != parser.m_size)
+        return;
+
+    Entry entry;
+    entry.mtime = mtime;
+    entry.size = size;
+    entry.hash = Hash(parser.m_data, parser.m_size);
+    entry.dirty = true;
+    entry.commands = parser.m_commands;
+    entry.arguments = parser.m_arguments;
+    entry.variables = parser.m_variables;
+    entry.references = parser.m_references;
+    entry.errors = parser.m_errors;
+
+    wxMutexLocker lock(m_mutex);
+    m_entries[parser.m_filename.GetFullPath()] = entry;
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeParseCache::Load(const wxFileName& filename)
+{
+    if (!filename.FileExists())
+        return false;
+
+    try {
+        wxSQLite3Database db;
+
+        db.Open(filename.GetFullPath());
+
+        // Not opened
+        if (!db.IsOpen())
+            return false;
+
+        // Different format
+        if (db.ExecuteScalar("PRAGMA user_version") != CACHE_VERSION)
+            return false;
+
+        wxSQLite3ResultSet res = db.ExecuteQuery("SELECT path, mtime, size, hash, data FROM files");
+
+        // Entries of removed files
+        wxArrayString removed;
+
+        while (res.NextRow()) {
+            const wxString path = res.GetAsString(0);
+
+            if (!wxFileName::FileExists(path)) {
+                removed.Add(path);
+                continue;
+            }
+
+            wxMemoryBuffer buffer;
+            res.GetBlob(4, buffer);
+
+            CacheReader reader(static_cast<const char*>(buffer.GetData()), buffer.GetDataLen());
+
+            Entry entry;
+            entry.mtime = res.GetInt64(1).GetValue();
+            entry.size = res.GetInt64(2).GetValue();
+            entry.hash = res.GetInt64(3).GetValue();
+            entry.dirty = false;
+
+            // Symbols, IDs are valid only in one process
+            wxVector<CMakeSymbols::Id> symbols(reader.ReadCount(sizeof(wxUint64)));
+            for (size_t i = 0; i < symbols.size() && reader.IsOk(); ++i) {
+                symbols[i] = CMakeSymbols::Get().Intern(reader.ReadString());
+            }
+
+            // Commands
+            entry.commands.resize(reader.ReadCount(5 * sizeof(wxUint64)));
+            for (size_t i = 0; i < entry.commands.size() && reader.IsOk(); ++i) {
+                CMakeParser::Command& command = entry.commands[i];
+                command.pos = reader.ReadInt();
+                command.length = reader.ReadInt();
+                command.name = reader.ReadSymbol(symbols);
+                command.firstArgument = reader.ReadInt();
+                command.argumentCount = reader.ReadInt();
+            }
+
+            // Arguments
+            entry.arguments.resize(reader.ReadCount(2 * sizeof(wxUint64)));
+            for (size_t i = 0; i < entry.arguments.size() && reader.IsOk(); ++i) {
+                entry.arguments[i].pos = reader.ReadInt();
+                entry.arguments[i].length = reader.ReadInt();
+            }
+
+            // Variables
+            entry.variables.resize(reader.ReadCount(sizeof(wxUint64)));
+            for (size_t i = 0; i < entry.variables.size() && reader.IsOk(); ++i) {
+                entry.variables[i] = reader.ReadSymbol(symbols);
+            }
+
+            std::sort(entry.variables.begin(), entry.variables.end());
+
+            // References
+            entry.references.resize(reader.ReadCount(4 * sizeof(wxUint64)));
+            for (size_t i = 0; i < entry.references.size() && reader.IsOk(); ++i) {
+                CMakeParser::Reference& reference = entry.references[i];
+                reference.pos = reader.ReadInt();
+                reference.length = reader.ReadInt();
+                reference.name = reader.ReadSymbol(symbols);
+                reference.definition = reader.ReadInt() != 0;
+            }
+
+            // Errors
+            entry.errors.resize(reader.ReadCount(2 * sizeof(wxUint64)));
+            for (size_t i = 0; i < entry.errors.size() && reader.IsOk(); ++i) {
+                entry.errors[i].pos = reader.ReadInt();
+
+                // Unknown codes are stored as ErrorCount and rejected by IsValid
+                const wxUint64 code = std::min<wxUint64>(reader.ReadInt(), CMakeParser::ErrorCount);
+                entry.errors[i].code = static_cast<CMakeParser::ErrorCode>(code);
+            }
+
+            // Broken data, file will be parsed again
+            if (!reader.IsOk() || !IsValid(entry)) {
+                CMAKE_WARNING("CMake parse cache: invalid entry of '%s'", path);
+                continue;
+            }
+
+            wxMutexLocker lock(m_mutex);
+            m_entries[path] = entry;
+        }
+
+        res.Finalize();
+
+        // Prune removed files
+        if (!removed.IsEmpty()) {
+            db.Begin();
+
+            wxSQLite3Statement stmt = db.PrepareStatement("DELETE FROM files WHERE path = ?");
+
+            for (size_t i = 0; i < removed.GetCount(); ++i) {
+                stmt.Bind(1, removed[i]);
+                stmt.ExecuteUpdate();
+                stmt.Reset();
+            }
+
+            db.Commit();
+        }
+
+    } catch (const wxSQLite3Exception& e) {
+        CMAKE_ERROR("Error occured while loading CMake parse cache: %s", e.GetMessage());
+        return false;
+    }
+
+    return true;
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeParseCache::Save(const wxFileName& filename)
+{
+    try {
+        wxSQLite3Database db;
+
+        db.Open(filename.GetFullPath());
+
+        // Not opened
+        if (!db.IsOpen())
+            return false;
+
+        // Data in different format are dropped
+        if (db.ExecuteScalar("PRAGMA user_version") != CACHE_VERSION) {
+            db.ExecuteUpdate("DROP TABLE IF EXISTS files");
+            db.ExecuteUpdate(wxString::Format("PRAGMA user_version = %d", CACHE_VERSION));
+        }
+
+        db.ExecuteUpdate("CREATE TABLE IF NOT EXISTS files (path TEXT PRIMARY KEY, mtime INTEGER, size INTEGER, hash INTEGER, data BLOB)");
+
+        db.Begin();
+
+        wxSQLite3Statement stmt = db.PrepareStatement("INSERT OR REPLACE INTO files (path, mtime, size, hash, data) VALUES(?, ?, ?, ?, ?)");
+
+        wxMutexLocker lock(m_mutex);
+
+        for (std::map<wxString, Entry>::iterator it = m_entries.begin(), ite = m_entries.end(); it != ite; ++it) {
+            Entry& entry = it->second;
+
+            if (!entry.dirty)
+                continue;
+
+            CacheWriter writer;
+
+            // Symbols used by the entry
+            SymbolTable symbols;
+            for (wxVector<CMakeParser::Command>::const_iterator cit = entry.commands.begin(),
+                cite = entry.commands.end(); cit != cite; ++cit) {
+                symbols.Add(cit->name);
+            }
+
+            for (wxVector<CMakeSymbols::Id>::const_iterator vit = entry.variables.begin(),
+                vite = entry.variables.end(); vit != vite; ++vit) {
+                symbols.Add(*vit);
+            }
+
+            for (wxVector<CMakeParser::Reference>::const_iterator rit = entry.references.begin(),
+                rite = entry.references.end(); rit != rite; ++rit) {
+                symbols.Add(rit->name);
+            }
+
+            writer.WriteInt(symbols.ids.size());
+            for (size_t i = 0; i < symbols.ids.size(); ++i) {
+                writer.WriteString(CMakeSymbols::Get().GetName(symbols.ids[i]));
+            }
+
+            // Commands
+            writer.WriteInt(entry.commands.size());
+            for (wxVector<CMakeParser::Command>::const_iterator cit = entry.commands.begin(),
+                cite = entry.commands.end(); cit != cite; ++cit) {
+                writer.WriteInt(cit->pos);
+                writer.WriteInt(cit->length);
+                writer.WriteInt(symbols.indices[cit->name]);
+                writer.WriteInt(cit->firstArgument);
+                writer.WriteInt(cit->argumentCount);
+            }
+
+            // Arguments
+            writer.WriteInt(entry.arguments.size());
+            for (wxVector<CMakeParser::Span>::const_iterator ait = entry.arguments.begin(),
+                aite = entry.arguments.end(); ait != aite; ++ait) {
+                writer.WriteInt(ait->pos);
+                writer.WriteInt(ait->length);
+            }
+
+            // Variables
+            writer.WriteInt(entry.variables.size());
+            for (wxVector<CMakeSymbols::Id>::const_iterator vit = entry.variables.begin(),
+                vite = entry.variables.end(); vit != vite; ++vit) {
+                writer.WriteInt(symbols.indices[*vit]);
+            }
+
+            // References
+            writer.WriteInt(entry.references.size());
+            for (wxVector<CMakeParser::Reference>::const_iterator rit = entry.references.begin(),
+                rite = entry.references.end(); rit != rite; ++rit) {
+                writer.WriteInt(rit->pos);
+                writer.WriteInt(rit->length);
+                writer.WriteInt(symbols.indices[rit->name]);
+                writer.WriteInt(rit->definition);
+            }
+
+            // Errors
+            writer.WriteInt(entry.errors.size());
+            for (wxVector<CMakeParser::Error>::const_iterator eit = entry.errors.begin(),
+                eite = entry.errors.end(); eit != eite; ++eit) {
+                writer.WriteInt(eit->pos);
+                writer.WriteInt(static_cast<wxUint64>(eit->code));
+            }
+
+            stmt.Bind(1, it->first);
+            stmt.Bind(2, wxLongLong(entry.mtime));
+            stmt.Bind(3, wxLongLong(static_cast<wxLongLong_t>(entry.size)));
+            stmt.Bind(4, wxLongLong(static_cast<wxLongLong_t>(entry.hash)));
+            stmt.Bind(5, writer.GetBuffer());
+            stmt.ExecuteUpdate();
+            stmt.Reset();
+
+            entry.dirty = false;
+        }
+
+        db.Commit();
+
+    } catch (const wxSQLite3Exception& e) {
+        CMAKE_ERROR("An error occured while storing CMake parse cache: %s", e.GetMessage());
+        return false;
+    }
+
+    return true;
+}
+
+/* ************************************************************************ */
+
+void
+CMakeParseCache::Restore(const Entry& entry, CMakeParser& parser)
+{
+    parser.m_commands = entry.commands;
+    parser.m_arguments = entry.arguments;
+    parser.m_variables = entry.variables;
+    parser.m_references = entry.references;
+    parser.m_errors = entry.errors;
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeParseCache::IsValid(const Entry& entry)
+{
+    for (wxVector<CMakeParser::Command>::const_iterator it = entry.commands.begin(),
+        ite = entry.commands.end(); it != ite; ++it) {
+        if (!IsInside(it->pos, it->length, entry.size) ||
+            !IsInside(it->firstArgument, it->argumentCount, entry.arguments.size()))
+            return false;
+    }
+
+    for (wxVector<CMakeParser::Span>::const_iterator it = entry.arguments.begin(),
+        ite = entry.arguments.end(); it != ite; ++it) {
+        if (!IsInside(it->pos, it->length, entry.size))
+            return false;
+    }
+
+    for (wxVector<CMakeParser::Reference>::const_iterator it = entry.references.begin(),
+        ite = entry.references.end(); it != ite; ++it) {
+        if (!IsInside(it->pos, it->length, entry.size))
+            return false;
+    }
+
+    for (wxVector<CMakeParser::Error>::const_iterator it = entry.errors.begin(),
+        ite = entry.errors.end(); it != ite; ++it) {
+        if (it->pos > entry.size || it->code >= CMakeParser::ErrorCount)
+            return false;
+    }
+
+    return true;
+}
+
+/* ************************************************************************ */
+
+wxUint64
+CMakeParseCache::Hash(const char* data, size_t size, wxUint64 hash)
+{
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= wxULL(1099511628211);
+    }
+
+    return hash;
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeParseCache::GetFileInfo(const wxFileName& filename, wxLongLong_t& mtime,
+                             wxUint64& size)
+{
+    wxDateTime time;
+
+    if (!filename.GetTimes(NULL, &time, NULL))
+        return false;
+
+    const wxULongLong fileSize = filename.GetSize();
+
+    if (fileSize == wxInvalidSize)
+        return false;
+
+    // Milliseconds
+    mtime = time.GetValue().GetValue();
+    size = fileSize.GetValue();
+
+    return true;
+}
+
+/* ************************************************************************ */
@@ -0,0 +1,249 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+#ifndef CMAKE_PARSE_CACHE_H_
+#define CMAKE_PARSE_CACHE_H_
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// C++
+#include <map>
+
+// wxWidgets
+#include <wx/string.h>
+#include <wx/arrstr.h>
+#include <wx/vector.h>
+#include <wx/filename.h>
+#include <wx/thread.h>
+
+// CMakePlugin
+#include "CMakeParser.h"
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Cache of parsed CMake files.
+ *
+ * Results of parsing (commands, variables, references and errors) are
+ * stored by file path together with modification time, size and hash
+ * of the content. If the time and size match, the cached result is used
+ * without reading the file. Otherwise the content hash is compared and
+ * the file is tokenized only when it was really changed.
+ *
+ * Cache can be stored into SQLite database and loaded on next start.
+ * It's safe to use the cache from multiple threads.
+ */
+class CMakeParseCache
+{
+
+// Public Ctors
+public:
+
+
+    /**
+     * @brief Constructor.
+     */
+    CMakeParseCache();
+
+
+// Public Accessors
+public:
+
+
+    /**
+     * @brief Returns number of cached files.
+     *
+     * @return
+     */
+    size_t GetCount() const;
+
+
+// Public Operations
+public:
+
+
+    /**
+     * @brief Removes all cached results.
+     */
+    void Clear();
+
+
+    /**
+     * @brief Restores result of parsing of the parser's current file.
+     *
+     * Parser must have file mapped (it's called from CMakeParser::ParseFile).
+     * Modification time and size must be taken before the file was mapped
+     * so a change made meanwhile is detected.
+     *
+     * @param parser Parser.
+     * @param mtime  File modification time.
+     * @param size   File size.
+     *
+     * @return If result was found in cache.
+     */
+    bool Restore(CMakeParser& parser, wxLongLong_t mtime, wxUint64 size);
+
+
+    /**
+     * @brief Stores result of parsing of the parser's current file.
+     *
+     * Nothing is stored if the mapped content doesn't have given size
+     * (file was changed while it was mapped).
+     *
+     * @param parser Parser.
+     * @param mtime  File modification time taken before mapping.
+     * @param size   File size taken before mapping.
+     */
+    void Store(const CMakeParser& parser, wxLongLong_t mtime, wxUint64 size);
+
+
+    /**
+     * @brief Loads cache from SQLite database.
+     *
+     * Entries of files that no longer exist are removed from the database.
+     *
+     * @param filename Path to database.
+     *
+     * @return If cache was loaded.
+     */
+    bool Load(const wxFileName& filename);
+
+
+    /**
+     * @brief Stores changed entries into SQLite database.
+     *
+     * @param filename Path to database.
+     *
+     * @return If cache was stored.
+     */
+    bool Save(const wxFileName& filename);
+
+
+    /**
+     * @brief Calculates hash of the data (64-bit FNV-1a).
+     *
+     * Data can be hashed in parts, the previous result is passed as
+     * the initial hash of the next part.
+     *
+     * @param data Data.
+     * @param size Size of data.
+     * @param hash Initial hash.
+     *
+     * @return
+     */
+    static wxUint64 Hash(const char* data, size_t size,
+                         wxUint64 hash = wxULL(14695981039346656037));
+
+
+    /**
+     * @brief Returns modification time and size of the file.
+     *
+     * @param filename File path.
+     * @param mtime    Output modification time.
+     * @param size     Output size.
+     *
+     * @return If file exists.
+     */
+    static bool GetFileInfo(const wxFileName& filename, wxLongLong_t& mtime,
+                            wxUint64& size);
+
+
+// Private Structures
+private:
+
+
+    /**
+     * @brief Cached result of parsing.
+     */
+    struct Entry
+    {
+        /// File modification time.
+        wxLongLong_t mtime;
+
+        /// File size.
+        wxUint64 size;
+
+        /// Content hash.
+        wxUint64 hash;
+
+        /// If entry is not stored in the database.
+        bool dirty;
+
+        /// Parsed commands.
+        wxVector<CMakeParser::Command> commands;
+
+        /// Arguments of all commands.
+        wxVector<CMakeParser::Span> arguments;
+
+        /// Defined variables (sorted symbols).
+        wxVector<CMakeSymbols::Id> variables;
+
+        /// Variable references.
+        wxVector<CMakeParser::Reference> references;
+
+        /// Errors.
+        wxVector<CMakeParser::Error> errors;
+    };
+
+
+// Private Operations
+private:
+
+
+    /**
+     * @brief Copies cached result into parser.
+     *
+     * @param entry  Cached entry (valid, see IsValid).
+     * @param parser Parser.
+     */
+    static void Restore(const Entry& entry, CMakeParser& parser);
+
+
+    /**
+     * @brief Checks if all indices and spans of the entry are within its
+     * arguments and the file size.
+     *
+     * @param entry Entry loaded from the database.
+     *
+     * @return If the entry can be restored into a parser.
+     */
+    static bool IsValid(const Entry& entry);
+
+
+// Private Data Members
+private:
+
+
+    /// Cached entries by file path.
+    std::map<wxString, Entry> m_entries;
+
+    /// Guards the entries.
+    mutable wxMutex m_mutex;
+
+};
+
+/* ************************************************************************ */
+
+#endif // CMAKE_PARSE_CACHE_H_
@@ -25,13 +25,67 @@
 // Declaration
 #include "CMakeParser.h"
 
+// CMakePlugin
+#include "CMakeParseCache.h"
+
 // C++
 #include <cctype>
 #include <cassert>
-#include <iterator>
+#include <algorithm>
+#include <cstring>
+
+/* ************************************************************************ */
+/* VARIABLES                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Character classes.
+ */
+enum CharClass
+{
+    /// Whitespace (space, tab, CR, LF).
+    CharSpace = 0x01,
+
+    /// Terminates unquoted argument (whitespace, parentheses, '#', '"').
+    CharDelimiter = 0x02,
 
-// wxWidgets
-#include <wx/ffile.h>
+    /// Identifier character (a-z, A-Z, 0-9, _).
+    CharIdentifier = 0x04,
+
+    /// First identifier character (a-z, A-Z, _).
+    CharIdentifierStart = 0x08,
+
+    /// Escape character ('\').
+    CharEscape = 0x10
+};
+
+#define S CharSpace
+#define D CharDelimiter
+#define I CharIdentifier
+#define F CharIdentifierStart
+#define E CharEscape
+
+/**
+ * @brief Class of each byte. Bytes of UTF-8 multibyte sequences
+ * (>= 0x80) have no class so they're part of unquoted arguments.
+ */
+static const unsigned char CHAR_CLASSES[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, S|D, S|D, 0, 0, S|D, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    S|D, 0, D, D, 0, 0, 0, 0, D, D, 0, 0, 0, 0, 0, 0,
+    I, I, I, I, I, I, I, I, I, I, 0, 0, 0, 0, 0, 0,
+    0, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F,
+    I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, 0, E, 0, 0, I|F,
+    0, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F,
+    I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, I|F, 0, 0, 0, 0, 0
+    // The rest is zero
+};
+
+#undef S
+#undef D
+#undef I
+#undef F
+#undef E
 
 /* ************************************************************************ */
 /* STRUCTURES                                                               */
@@ -39,35 +93,38 @@
 
 /**
  * @brief Parse token.
+ *
+ * Token doesn't store its value, only position in the source.
  */
 struct Token
 {
-    /// Token start position.
-    wxString::size_type start;
+    /// Token start position (in bytes).
+    size_t start;
 
-    /// Token length.
-    wxString::size_type length;
+    /// Token length (in bytes).
+    size_t length;
 
     /// Token type.
     enum {
         TypeUnknown = 0,
         TypeIdentifier,
-        TypeString,
+        TypeUnquoted,
+        TypeQuoted,
+        TypeBracket,
         TypeLeftParen,
         TypeRightParen,
         TypeComment,
-        TypeSpace,
-        TypeVariable
+        TypeSpace
     } type;
-
-    /// String value.
-    wxString value;
 };
 
 /* ************************************************************************ */
 
 /**
  * @brief Iterator pair.
+ *
+ * Iterates over bytes of UTF-8 encoded source. Multibyte characters
+ * are never part of the CMake syntax so they're handled byte by byte.
  */
 struct IteratorPair
 {
@@ -76,13 +133,13 @@ struct IteratorPair
 public:
 
     /// Start position.
-    wxString::const_iterator start;
+    const char* start;
 
     /// Current position.
-    wxString::const_iterator current;
+    const char* current;
 
     /// Input end position.
-    wxString::const_iterator end;
+    const char* end;
 
 
 // Public Ctors
@@ -95,7 +152,7 @@ public:
      * @param beg Source begin.
      * @param end Source end.
      */
-    IteratorPair(wxString::const_iterator beg, wxString::const_iterator end)
+    IteratorPair(const char* beg, const char* end)
         : start(beg), current(beg), end(end)
     {}
 
@@ -110,8 +167,8 @@ public:
      *
      * @return Offset
      */
-    wxString::size_type GetOffset() const {
-        return std::distance(start, current);
+    size_t GetOffset() const {
+        return current - start;
     }
 
 
@@ -120,7 +177,7 @@ public:
      *
      * @return
      */
-    wxUniChar Get() const {
+    char Get() const {
         return *current;
     }
 
@@ -153,57 +210,102 @@ public:
      *
      * @return
      */
-    bool Is(wxUniChar ch) const {
+    bool Is(char ch) const {
         return Get() == ch;
     }
 
 
     /**
-     * @brief Test if current character is in given range.
+     * @brief Returns class of the current character.
      *
-     * @param ch1
-     * @param ch2
-     *
-     * @return
+     * @return Combination of CharClass values.
      */
-    bool IsRange(wxUniChar ch1, wxUniChar ch2) const {
-        return Get() >= ch1 && Get() <= ch2;
+    unsigned GetClass() const {
+        return CHAR_CLASSES[static_cast<unsigned char>(*current)];
     }
 
 
     /**
-     * @brief Checks if current character is alpha (a-z).
+     * @brief Test if current character has given class.
+     *
+     * @param cls CharClass value.
      *
      * @return
      */
-    bool IsAlpha() const {
-        return IsRange('a', 'z') || IsRange('A', 'Z');
+    bool IsClass(unsigned cls) const {
+        return (GetClass() & cls) != 0;
     }
 
+};
 
-    /**
-     * @brief Checks if current character is alphanumeric (a-z|0-9).
-     *
-     * @return
-     */
-    bool IsAlphaNumberic() const {
-        return IsAlpha() || IsRange('0', '9');
-    }
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
 
+/**
+ * @brief Tries to read bracket opening "[=*[".
+ *
+ * Current character must be '['. If bracket opening is found
+ * it's skipped.
+ *
+ * @param context Parsing context.
+ * @param level   Output number of '=' characters.
+ *
+ * @return If bracket opening was found.
+ */
+static bool ReadBracketOpen(IteratorPair& context, size_t& level)
+{
+    const char* pos = context.current + 1;
 
-    /**
-     * @brief Checks if current character identifier (a-z|0-9|_).
-     *
-     * @return
-     */
-    bool IsIdentifier() const {
-        return IsAlphaNumberic() || Is('_');
-    }
+    while (pos != context.end && *pos == '=')
+        ++pos;
 
-};
+    if (pos == context.end || *pos != '[')
+        return false;
+
+    level = pos - context.current - 1;
+    context.current = pos + 1;
+    return true;
+}
 
 /* ************************************************************************ */
-/* FUNCTIONS                                                                */
+
+/**
+ * @brief Skips bracket content including closing "]=*]".
+ *
+ * @param context Parsing context.
+ * @param level   Number of '=' characters.
+ *
+ * @return If closing bracket was found.
+ */
+static bool SkipBracketContent(IteratorPair& context, size_t level)
+{
+    while (!context.IsEof()) {
+        const char* close = static_cast<const char*>(
+            memchr(context.current, ']', context.end - context.current)
+        );
+
+        if (!close)
+            break;
+
+        const char* pos = close + 1;
+
+        while (pos != context.end && *pos == '=')
+            ++pos;
+
+        if (pos != context.end && *pos == ']' &&
+            static_cast<size_t>(pos - close - 1) == level) {
+            context.current = pos + 1;
+            return true;
+        }
+
+        context.current = close + 1;
+    }
+
+    context.current = context.end;
+    return false;
+}
+
 /* ************************************************************************ */
 
 /**
@@ -211,107 +313,126 @@ public:
  *
  * @param context Parsing context.
  * @param token   Output token.
+ * @param errors  Output errors (unterminated strings, brackets).
  */
-static void GetToken(IteratorPair& context, Token& token)
+static void GetToken(IteratorPair& context, Token& token,
+                     wxVector<CMakeParser::Error>& errors)
 {
     // EOS
     if (context.IsEof())
         return;
 
     token.type = Token::TypeUnknown;
-    token.value.clear();
     token.start = context.GetOffset();
 
-    if (context.Is('#')) {
+    size_t level;
 
-        // COMMENT
-        token.type = Token::TypeComment;
+    if (context.IsClass(CharSpace)) {
 
-        // Everything until EOL is part of the comment
-        while (!context.IsEof() && !context.Is('\n')) {
-            token.value += context.Get();
-            context.Next();
-        }
+        // WHITESPACE
+        token.type = Token::TypeSpace;
 
-        context.Next();
+        do {
+            context.Next();
+        } while (!context.IsEof() && context.IsClass(CharSpace));
 
     } else if (context.Is('(')) {
 
         // LEFT PARENTHESIS
         token.type = Token::TypeLeftParen;
-        token.value += context.Get();
         context.Next();
 
     } else if (context.Is(')')) {
 
         // RIGHT PARENTHESIS
         token.type = Token::TypeRightParen;
-        token.value += context.Get();
         context.Next();
 
-    } else if (context.Is(' ') || context.Is('\n') || context.Is('\t')) {
+    } else if (context.Is('#')) {
 
-        // WHITESPACE
-        token.type = Token::TypeSpace;
-        token.value += context.Get();
+        // COMMENT
+        token.type = Token::TypeComment;
         context.Next();
 
-    } else if (context.IsAlpha()) {
+        if (!context.IsEof() && context.Is('[') && ReadBracketOpen(context, level)) {
 
-        token.type = Token::TypeIdentifier;
-        token.value += context.Get();
-        context.Next();
+            // Bracket comment
+            if (!SkipBracketContent(context, level)) {
+                CMakeParser::Error error = {token.start, CMakeParser::ErrorUnterminatedBracket};
+                errors.push_back(error);
+            }
 
-        // Rest of the identifier
-        while (!context.IsEof() && context.IsIdentifier()) {
-            token.value += context.Get();
-            context.Next();
+        } else {
+
+            // Everything until EOL is part of the comment
+            const char* eol = static_cast<const char*>(
+                memchr(context.current, '\n', context.end - context.current)
+            );
+
+            context.current = eol ? eol + 1 : context.end;
         }
 
-    } else if (context.Is('$')) {
+    } else if (context.Is('"')) {
 
-        // VARIABLE
-        token.value += context.Get();
+        // QUOTED ARGUMENT
+        token.type = Token::TypeQuoted;
         context.Next();
 
-        if (context.Is('{')) {
+        bool closed = false;
 
-            token.type = Token::TypeVariable;
-            token.value += context.Get();
-            context.Next();
+        while (!context.IsEof()) {
+            if (context.Is('"')) {
+                context.Next();
+                closed = true;
+                break;
+            }
 
-            // Rest of the identifier
-            while (!context.IsEof() && context.IsIdentifier()) {
-                token.value += context.Get();
+            // Escape sequence or line continuation
+            if (context.IsClass(CharEscape)) {
                 context.Next();
+
+                if (context.IsEof())
+                    break;
             }
 
-            // TODO Check }
-            token.value += context.Get();
             context.Next();
+        }
 
-        } else if (context.Is('(')) {
+        if (!closed) {
+            CMakeParser::Error error = {token.start, CMakeParser::ErrorUnterminatedString};
+            errors.push_back(error);
+        }
 
-            token.type = Token::TypeVariable;
-            token.value += context.Get();
-            context.Next();
+    } else if (context.Is('[') && ReadBracketOpen(context, level)) {
 
-            // Rest of the identifier
-            while (!context.IsEof() && context.IsIdentifier()) {
-                token.value += context.Get();
-                context.Next();
-            }
+        // BRACKET ARGUMENT
+        token.type = Token::TypeBracket;
 
-            // TODO Check )
-            token.value += context.Get();
-            context.Next();
+        if (!SkipBracketContent(context, level)) {
+            CMakeParser::Error error = {token.start, CMakeParser::ErrorUnterminatedBracket};
+            errors.push_back(error);
         }
 
     } else {
 
-        token.value += context.Get();
-        context.Next();
+        // UNQUOTED ARGUMENT or IDENTIFIER
+        bool identifier = context.IsClass(CharIdentifierStart);
+
+        while (!context.IsEof() && !context.IsClass(CharDelimiter)) {
+            identifier = identifier && context.IsClass(CharIdentifier);
+
+            // Escape sequence
+            if (context.IsClass(CharEscape)) {
+                context.Next();
 
+                if (context.IsEof())
+                    break;
+            }
+
+            context.Next();
+        }
+
+        token.type = identifier ? Token::TypeIdentifier : Token::TypeUnquoted;
     }
 
     // Calculate token size
@@ -320,44 +441,92 @@ static void GetToken(IteratorPair& context, Token& token)
 
 /* ************************************************************************ */
 
+/**
+ * @brief Adds error and keeps errors ordered by position.
+ *
+ * Errors are mostly found in order so the position is searched
+ * from the end.
+ *
+ * @param errors Errors.
+ * @param error  New error.
+ */
+static void AddError(wxVector<CMakeParser::Error>& errors, const CMakeParser::Error& error)
+{
+    wxVector<CMakeParser::Error>::iterator it = errors.end();
+
+    while (it != errors.begin() && (it - 1)->pos > error.pos)
+        --it;
+
+    errors.insert(it, error);
+}
+
+/* ************************************************************************ */
+
 /**
  * @brief Parses command.
  *
- * @param context Parse context.
- * @param command Output variable.
- * @param errors  Container for errors.
+ * Nested parentheses in arguments (e.g. in if() conditions) are stored
+ * as separate arguments like CMake does.
+ *
+ * @param context   Parsing context.
+ * @param command   Output command, name is not set.
+ * @param name      Output position of the command name.
+ * @param arguments Pool where the arguments are appended.
+ * @param errors    Output errors.
+ *
+ * @return If command was parsed.
  */
 static bool ParseCommand(IteratorPair& context, CMakeParser::Command& command,
+                         CMakeParser::Span& name, wxVector<CMakeParser::Span>& arguments,
                          wxVector<CMakeParser::Error>& errors)
 {
     command.pos = 0;
-    command.name.clear();
-    command.arguments.clear();
+    command.length = 0;
+    command.name = 0;
+    command.firstArgument = arguments.size();
+    command.argumentCount = 0;
 
     Token token;
 
-    // Skip spaces and find identifier (command name)
-    for (GetToken(context, token); !context.IsEof(); GetToken(context, token)) {
+    // Skip spaces and comments and find identifier (command name),
+    // the last token before EOF must be checked too
+    while (true) {
+        // Done
+        if (context.IsEof())
+            return false;
+
+        GetToken(context, token, errors);
+
         // Identifier found
         if (token.type == Token::TypeIdentifier) {
             break;
+        } else if (token.type != Token::TypeSpace && token.type != Token::TypeComment) {
+            // Expected command name
+            CMakeParser::Error error = {token.start, CMakeParser::ErrorUnexpectedToken};
+            errors.push_back(error);
         }
     }
 
-    // Done
-    if (context.IsEof())
-        return false;
-
     // Must be an identifier
     assert(token.type == Token::TypeIdentifier);
 
-    // Store command name
-    command.name = token.value;
+    // Store command name position
+    name.pos = token.start;
+    name.length = token.length;
     command.pos = token.start;
 
     // Skip spaces and find open parenthessis
-    for (GetToken(context, token); !context.IsEof(); GetToken(context, token)) {
-        // Identifier found
+    while (true) {
+        // Unexpected EOF, command name is not followed by '('
+        if (context.IsEof()) {
+            CMakeParser::Error error = {name.pos, CMakeParser::ErrorUnexpectedToken};
+            AddError(errors, error);
+            return false;
+        }
+
+        GetToken(context, token, errors);
+
+        // Open parenthesis found
         if (token.type == Token::TypeLeftParen) {
             break;
         } else if (token.type == Token::TypeSpace) {
@@ -371,52 +540,173 @@ static bool ParseCommand(IteratorPair& context, CMakeParser::Command& command,
         }
     }
 
-    // Unexpected EOF.
-    if (context.IsEof())
-        // TODO add error?
-        return false;
-
     // Must be a '('
     assert(token.type == Token::TypeLeftParen);
 
-    // Parse next token
-    GetToken(context, token);
+    // Current argument, tokens of one argument are adjacent
+    CMakeParser::Span arg = {0, 0};
 
-    // Command have arguments
-    if (token.type != Token::TypeRightParen) {
+    // Nested parentheses
+    size_t depth = 0;
 
-        wxString arg;
+    bool closed = false;
 
-        // Read tokens
-        for (; !context.IsEof(); GetToken(context, token)) {
-            // End of arguments
-            if (token.type == Token::TypeRightParen) {
-                break;
-            }
+    // Read tokens
+    while (!context.IsEof()) {
+        GetToken(context, token, errors);
 
-            // Next argument
-            if (token.type == Token::TypeSpace) {
+        const bool paren = token.type == Token::TypeLeftParen || token.type == Token::TypeRightParen;
 
-                // Store argument
-                if (!arg.IsEmpty())
-                    command.arguments.push_back(arg);
+        // Tokens of one argument are adjacent
+        if (!paren && token.type != Token::TypeSpace && token.type != Token::TypeComment) {
+            if (!arg.length)
+                arg.pos = token.start;
 
-                arg.Clear();
-                continue;
-            }
+            arg.length = token.start + token.length - arg.pos;
+            continue;
+        }
+
+        // Store argument
+        if (arg.length)
+            arguments.push_back(arg);
+
+        arg.length = 0;
 
-            // Add token value
-            arg += token.value;
+        // End of arguments
+        if (token.type == Token::TypeRightParen && !depth) {
+            closed = true;
+            break;
         }
 
-        // Store last argument
-        if (!arg.IsEmpty())
-            command.arguments.push_back(arg);
+        // Nested parenthesis is an argument too
+        if (paren) {
+            if (token.type == Token::TypeLeftParen)
+                ++depth;
+            else
+                --depth;
 
+            CMakeParser::Span span = {token.start, token.length};
+            arguments.push_back(span);
+        }
     }
 
-    // Command must ends with close paren
-    return (token.type == Token::TypeRightParen);
+    // Store last argument
+    if (arg.length)
+        arguments.push_back(arg);
+
+    // Command length including the parenthesis
+    command.length = context.GetOffset() - command.pos;
+    command.argumentCount = arguments.size() - command.firstArgument;
+
+    // Command must ends with close paren, arguments of incomplete
+    // command are dropped
+    if (!closed)
+        arguments.resize(command.firstArgument);
+
+    return closed;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Returns name of the variable defined by set() or option()
+ * without quotes, set("NAME" ...) defines NAME.
+ *
+ * @param data Source.
+ * @param span First argument.
+ *
+ * @return
+ */
+static CMakeParser::Span GetDefinedName(const char* data, const CMakeParser::Span& span)
+{
+    if (span.length >= 2 && data[span.pos] == '"' && data[span.pos + span.length - 1] == '"') {
+        const CMakeParser::Span name = {span.pos + 1, span.length - 2};
+        return name;
+    }
+
+    return span;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Checks if character can be part of variable name in
+ * ${NAME} reference (a-z, A-Z, 0-9, _, /, ., +, -).
+ *
+ * @param c Character.
+ *
+ * @return
+ */
+static inline bool IsVariableChar(char c)
+{
+    return (CHAR_CLASSES[static_cast<unsigned char>(c)] & CharIdentifier) ||
+        c == '/' || c == '.' || c == '+' || c == '-';
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Compares reference position (for binary search).
+ *
+ * @param reference Variable reference.
+ * @param pos       Position in the source.
+ *
+ * @return If reference starts before the position.
+ */
+static bool IsReferenceBefore(const CMakeParser::Reference& reference, size_t pos)
+{
+    return reference.pos < pos;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Returns position in the source after edit.
+ *
+ * @param pos     Position before edit.
+ * @param oldEnd  End of the replaced range.
+ * @param removed Number of removed bytes.
+ * @param length  Number of inserted bytes.
+ *
+ * @return
+ */
+static inline size_t ShiftPos(size_t pos, size_t oldEnd, size_t removed, size_t length)
+{
+    return pos >= oldEnd ? pos - removed + length : pos;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Replaces range of items by other items.
+ *
+ * Overlapping items are assigned in place so the vector is moved
+ * only when the number of items differs.
+ *
+ * @param items   Modified items.
+ * @param first   First replaced item.
+ * @param last    End of replaced items.
+ * @param replace New items.
+ */
+template<typename T>
+static void Splice(wxVector<T>& items, size_t first, size_t last, const wxVector<T>& replace)
+{
+    const size_t common = std::min(replace.size(), last - first);
+
+    for (size_t i = 0; i < common; ++i) {
+        items[first + i] = replace[i];
+    }
+
+    if (common < replace.size()) {
+        // wxVector has no range insert, make room at the end and move
+        // the following items
+        const size_t size = items.size();
+        items.resize(size + replace.size() - common);
+        std::copy_backward(items.begin() + last, items.begin() + size, items.end());
+        std::copy(replace.begin() + common, replace.end(), items.begin() + last);
+    } else if (common < last - first) {
+        items.erase(items.begin() + first + common, items.begin() + last);
+    }
 }
 
 /* ************************************************************************ */
@@ -424,6 +714,8 @@ static bool ParseCommand(IteratorPair& context, CMakeParser::Command& command,
 /* ************************************************************************ */
 
 CMakeParser::CMakeParser()
+    : m_data(NULL)
+    , m_size(0)
 {
     // Nothing to do
 }
@@ -434,33 +726,116 @@ void
 CMakeParser::Clear()
 {
     m_filename.Clear();
+    m_buffer.reset();
+    m_file.Close();
+    m_data = NULL;
+    m_size = 0;
     m_commands.clear();
+    m_arguments.clear();
+    m_variables.clear();
+    m_references.clear();
     m_errors.clear();
 }
 
 /* ************************************************************************ */
 
+void
+CMakeParser::ReleaseSource()
+{
+    m_buffer.reset();
+    m_file.Close();
+    m_data = NULL;
+    m_size = 0;
+}
+
+/* ************************************************************************ */
+
 bool
 CMakeParser::Parse(const wxString& content)
 {
     // Clear everything
     Clear();
 
+    // Keep UTF-8 source, commands refer to it
+    m_buffer = content.utf8_str();
+    m_data = m_buffer.data();
+    m_size = m_buffer.length();
+
+    return ParseData();
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeParser::ParseFile(const wxFileName& filename, CMakeParseCache* cache)
+{
+    // Clear everything
+    Clear();
+
+    m_filename = filename;
+
+    wxLongLong_t mtime = -1;
+    wxUint64 size = 0;
+
+    // File info must be taken before mapping, a change made meanwhile
+    // is then detected on the next parse
+    if (cache && !CMakeParseCache::GetFileInfo(m_filename, mtime, size))
+        cache = NULL;
+
+    // Map file
+    if (!m_file.Open(m_filename.GetFullPath()))
+        return false;
+
+    m_data = m_file.GetData();
+    m_size = m_file.GetSize();
+
+    // Unchanged file
+    if (cache && cache->Restore(*this, mtime, size))
+        return true;
+
+    const bool result = ParseData();
+
+    if (cache)
+        cache->Store(*this, mtime, size);
+
+    // Parsed files are rarely updated, don't keep interned names
+    m_symbols.Clear();
+
+    return result;
+}
+
+/* ************************************************************************ */
+
+wxArrayString
+CMakeParser::GetArguments(const Command& command) const
+{
+    wxArrayString arguments;
+    arguments.Alloc(command.argumentCount);
+
+    for (size_t i = 0; i < command.argumentCount; ++i) {
+        arguments.Add(GetArgument(command, i));
+    }
+
+    return arguments;
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeParser::ParseData()
+{
     Command command;
-    IteratorPair context(content.begin(), content.end());
+    Span name;
+    IteratorPair context(m_data, m_data + m_size);
+
+    // Skip UTF-8 BOM, positions are still from the beginning of the source
+    if (m_size >= 3 && !memcmp(m_data, "\xEF\xBB\xBF", 3))
+        context.current += 3;
 
     // Parse input into tokens
-    while (ParseCommand(context, command, m_errors)) {
-
-        // If command is 'set', store variable info
-        if (command.name == "set") {
-            if (!command.arguments.IsEmpty()) {
-                m_variables.insert(command.arguments[0]);
-            } else {
-                Error error = {command.pos, ErrorSetMissingArguments};
-                m_errors.push_back(error);
-            }
-        }
+    while (ParseCommand(context, command, name, m_arguments, m_errors)) {
+        command.name = m_symbols.InternFolded(m_data + name.pos, name.length);
+        CheckCommand(command, m_arguments, m_references, m_errors);
 
         // Add command
         m_commands.push_back(command);
@@ -471,23 +846,324 @@ CMakeParser::Parse(const wxString& content)
 
 /* ************************************************************************ */
 
-bool
-CMakeParser::ParseFile(const wxFileName& filename)
+void
+CMakeParser::CheckCommand(const Command& command, const wxVector<Span>& arguments,
+                          wxVector<Reference>& references, wxVector<Error>& errors)
 {
-    m_filename = filename;
+    size_t first = 0;
+
+    // If command is 'set', store variable info
+    if (command.name == CMakeSymbols::Set) {
+        if (command.argumentCount) {
+            const Span span = GetDefinedName(m_data, arguments[command.firstArgument]);
+            const CMakeSymbols::Id variable = m_symbols.Intern(m_data + span.pos, span.length);
+
+            // Keep variables sorted
+            wxVector<CMakeSymbols::Id>::iterator it = std::lower_bound(m_variables.begin(), m_variables.end(), variable);
+
+            if (it == m_variables.end() || *it != variable)
+                m_variables.insert(it, variable);
+        } else {
+            // Errors inside of the command are already stored
+            Error error = {command.pos, ErrorSetMissingArguments};
+            AddError(errors, error);
+        }
+    }
+
+    // Name of defined variable, computed names like set(${NAME} ...)
+    // are only uses
+    if ((command.name == CMakeSymbols::Set || command.name == CMakeSymbols::Option) &&
+        command.argumentCount) {
+        const Span span = GetDefinedName(m_data, arguments[command.firstArgument]);
+        const char* begin = m_data + span.pos;
+        const char* end = begin + span.length;
+        const char* it = begin;
+
+        while (it != end && IsVariableChar(*it))
+            ++it;
+
+        if (span.length && it == end) {
+            Reference reference = {
+                span.pos, span.length,
+                m_symbols.Intern(begin, span.length), true
+            };
+            references.push_back(reference);
+            first = 1;
+        }
+    }
+
+    for (size_t i = first; i < command.argumentCount; ++i) {
+        FindReferences(arguments[command.firstArgument + i], references);
+    }
+}
+
+/* ************************************************************************ */
+
+void
+CMakeParser::FindReferences(const Span& span, wxVector<Reference>& references) const
+{
+    const char* begin = m_data + span.pos;
+    const char* end = begin + span.length;
+
+    // Bracket arguments are not evaluated
+    if (begin != end && *begin == '[')
+        return;
+
+    for (const char* it = begin; it != end; ++it) {
+        // Escaped character
+        if (*it == '\\') {
+            if (++it == end)
+                break;
+
+            continue;
+        }
+
+        if (*it != '$' || end - it < 3 || it[1] != '{')
+            continue;
+
+        // Nested references like ${A_${B}} are found from the inner one
+        const char* name = it + 2;
+        const char* nameEnd = name;
 
-    // Open file
-    wxFFile file(m_filename.GetFullPath());
+        while (nameEnd != end && IsVariableChar(*nameEnd))
+            ++nameEnd;
 
-    // File cannot be opened
-    if (!file.IsOpened())
+        if (nameEnd == name || nameEnd == end || *nameEnd != '}')
+            continue;
+
+        Reference reference = {
+            static_cast<size_t>(name - m_data), static_cast<size_t>(nameEnd - name),
+            m_symbols.Intern(name, nameEnd - name), false
+        };
+        references.push_back(reference);
+        it = nameEnd;
+    }
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeParser::Update(size_t pos, size_t removed, const char* text, size_t length)
+{
+    // Invalid range
+    if (pos > m_size || removed > m_size - pos)
         return false;
 
-    // Read file content
-    wxString content;
-    file.ReadAll(&content);
+    const size_t oldEnd = pos + removed;
+    const size_t newEnd = pos + length;
+
+    // Old source is kept until the old commands are processed
+    const char* oldData = m_data;
+
+    // Apply the edit into a new buffer
+    wxCharBuffer buffer(m_size - removed + length);
+    {
+        char* data = buffer.data();
+
+        memcpy(data, m_data, pos);
+        memcpy(data + pos, text, length);
+        memcpy(data + newEnd, m_data + oldEnd, m_size - oldEnd);
+
+        m_data = data;
+        m_size = buffer.length();
+    }
+
+    // First command that ends after the edit start (it can contain the edit)
+    size_t first = 0;
+    for (size_t count = m_commands.size(); count > 0; ) {
+        const size_t half = count / 2;
+        const Command& cmd = m_commands[first + half];
+
+        if (cmd.pos + cmd.length <= pos) {
+            first += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+
+    // Tokenizer is in the same state after the end of previous command
+    const size_t start = first ? m_commands[first - 1].pos + m_commands[first - 1].length : 0;
+
+    IteratorPair context(m_data, m_data + m_size);
+    context.current += start;
+
+    if (!start && m_size >= 3 && !memcmp(m_data, "\xEF\xBB\xBF", 3))
+        context.current += 3;
+
+    // Parse until the first unchanged command is found, arguments of new
+    // commands are stored in a separate pool
+    wxVector<Command> commands;
+    wxVector<Span> arguments;
+    wxVector<Reference> references;
+    wxVector<Error> errors;
+    Command command;
+    Span name;
+    size_t next = first;
+    bool synced = false;
+
+    while (true) {
+        const size_t errorCount = errors.size();
+
+        if (!ParseCommand(context, command, name, arguments, errors))
+            break;
+
+        // Skip old commands before the new one
+        while (next < m_commands.size() && ShiftPos(m_commands[next].pos, oldEnd, removed, length) < command.pos)
+            ++next;
+
+        // Same text follows, the rest of old commands is still valid
+        if (command.pos >= newEnd && next < m_commands.size() && m_commands[next].pos >= oldEnd &&
+            ShiftPos(m_commands[next].pos, oldEnd, removed, length) == command.pos) {
+            // Errors of the command are already known, keep only errors
+            // found before the command
+            size_t count = errorCount;
+            while (count < errors.size() && errors[count].pos < command.pos)
+                ++count;
+
+            errors.resize(count);
+            arguments.resize(command.firstArgument);
+            synced = true;
+            break;
+        }
+
+        command.name = m_symbols.InternFolded(m_data + name.pos, name.length);
+        CheckCommand(command, arguments, references, errors);
+        commands.push_back(command);
+    }
+
+    // Old commands [first, last) and their arguments are replaced
+    const size_t last = synced ? next : m_commands.size();
+    const size_t syncPos = synced ? m_commands[last].pos : static_cast<size_t>(-1);
+    const size_t firstArgument = first < m_commands.size() ? m_commands[first].firstArgument : m_arguments.size();
+    const size_t lastArgument = last < m_commands.size() ? m_commands[last].firstArgument : m_arguments.size();
+
+    // Variables defined by replaced commands
+    wxVector<CMakeSymbols::Id> removedVariables;
+    for (size_t i = first; i < last; ++i) {
+        const Command& cmd = m_commands[i];
+
+        if (cmd.name == CMakeSymbols::Set && cmd.argumentCount) {
+            const Span span = GetDefinedName(oldData, m_arguments[cmd.firstArgument]);
+            removedVariables.push_back(m_symbols.Intern(oldData + span.pos, span.length));
+        }
+    }
+
+    // Old source is not required anymore
+    m_file.Close();
+    m_buffer = buffer;
+    m_data = m_buffer.data();
+
+    // Replace commands and arguments
+    for (wxVector<Command>::iterator it = commands.begin(), ite = commands.end(); it != ite; ++it) {
+        it->firstArgument += firstArgument;
+    }
+
+    Splice(m_commands, first, last, commands);
+    Splice(m_arguments, firstArgument, lastArgument, arguments);
+
+    // Shift following commands and arguments
+    const size_t argumentShift = arguments.size() - (lastArgument - firstArgument);
+
+    for (size_t i = first + commands.size(); i < m_commands.size(); ++i) {
+        m_commands[i].pos = m_commands[i].pos - removed + length;
+        m_commands[i].firstArgument += argumentShift;
+    }
+
+    for (size_t i = firstArgument + arguments.size(); i < m_arguments.size(); ++i) {
+        m_arguments[i].pos = m_arguments[i].pos - removed + length;
+    }
+
+    // Replace errors of replaced commands and shift the following ones
+    {
+        wxVector<Error> result;
+        wxVector<Error>::const_iterator it = m_errors.begin();
+
+        for (; it != m_errors.end() && it->pos < start; ++it) {
+            result.push_back(*it);
+        }
+
+        // Errors of new commands
+        for (wxVector<Error>::const_iterator itn = errors.begin(), itne = errors.end(); itn != itne; ++itn) {
+            result.push_back(*itn);
+        }
+
+        for (; it != m_errors.end(); ++it) {
+            if (it->pos < syncPos)
+                continue;
+
+            Error error = {it->pos - removed + length, it->code};
+            result.push_back(error);
+        }
+
+        m_errors.swap(result);
+    }
+
+    // References are always inside of commands, replace those of replaced
+    // commands and shift the following ones
+    {
+        const size_t firstReference = std::lower_bound(m_references.begin(), m_references.end(),
+            start, IsReferenceBefore) - m_references.begin();
+        const size_t lastReference = std::lower_bound(m_references.begin() + firstReference,
+            m_references.end(), syncPos, IsReferenceBefore) - m_references.begin();
+
+        Splice(m_references, firstReference, lastReference, references);
+
+        for (size_t i = firstReference + references.size(); i < m_references.size(); ++i) {
+            m_references[i].pos = m_references[i].pos - removed + length;
+        }
+    }
+
+    // Removed variables can be still defined by other commands
+    for (wxVector<CMakeSymbols::Id>::const_iterator it = removedVariables.begin(),
+        ite = removedVariables.end(); it != ite; ++it) {
+        if (!IsDefined(*it)) {
+            wxVector<CMakeSymbols::Id>::iterator pos = std::lower_bound(m_variables.begin(), m_variables.end(), *it);
+
+            if (pos != m_variables.end() && *pos == *it)
+                m_variables.erase(pos);
+        }
+    }
+
+    return true;
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeParser::Update(size_t pos, size_t removed, const wxString& text)
+{
+    const wxScopedCharBuffer utf8 = text.utf8_str();
+    return Update(pos, removed, utf8.data(), utf8.length());
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeParser::HasVariable(CMakeSymbols::Id name) const
+{
+    return std::binary_search(m_variables.begin(), m_variables.end(), name);
+}
+
+/* ************************************************************************ */
+
+bool
+CMakeParser::IsDefined(CMakeSymbols::Id name) const
+{
+    // Names are compared directly, they don't have to be interned
+    const wxScopedCharBuffer key = CMakeSymbols::Get().GetName(name).utf8_str();
+
+    for (wxVector<Command>::const_iterator it = m_commands.begin(), ite = m_commands.end(); it != ite; ++it) {
+        if (it->name != CMakeSymbols::Set || !it->argumentCount)
+            continue;
+
+        const Span span = GetDefinedName(m_data, GetArgumentSpan(*it, 0));
+
+        if (span.length == key.length() && !memcmp(m_data + span.pos, key.data(), span.length))
+            return true;
+    }
 
-    return Parse(content);
+    return false;
 }
 
 /* ************************************************************************ */
@@ -499,7 +1175,9 @@ CMakeParser::GetError(ErrorCode code)
     static wxString s_strings[ErrorCount] = {
         "Common error",
         "Unexpected token",
-        "Missing arguments for SET command"
+        "Missing arguments for SET command",
+        "Unterminated quoted argument",
+        "Unterminated bracket argument or comment"
     };
 
     return s_strings[code];
@@ -25,20 +25,31 @@
 /* INCLUDES                                                                 */
 /* ************************************************************************ */
 
-// C++
-#include <set>
-
 // wxWidgets
 #include <wx/string.h>
+#include <wx/buffer.h>
 #include <wx/vector.h>
 #include <wx/filename.h>
 
+// CMakePlugin
+#include "CMakeMappedFile.h"
+#include "CMakeSymbols.h"
+
+/* ************************************************************************ */
+/* FORWARD DECLARATIONS                                                     */
+/* ************************************************************************ */
+
+class CMakeParseCache;
+
 /* ************************************************************************ */
 /* CLASSES                                                                  */
 /* ************************************************************************ */
 
 /**
  * @brief CMake configuration files parser.
+ *
+ * Parser works over UTF-8 encoded source and all positions are byte
+ * offsets from the beginning of the source (same as in Scintilla).
  */
 class CMakeParser
 {
@@ -61,6 +72,12 @@ public:
         /// Missing argument for SET command.
         ErrorSetMissingArguments,
 
+        /// Quoted argument without closing quote.
+        ErrorUnterminatedString,
+
+        /// Bracket argument or comment without closing bracket.
+        ErrorUnterminatedBracket,
+
         /// Number of error codes.
         ErrorCount
     };
@@ -70,19 +87,68 @@ public:
 public:
 
 
+    /**
+     * @brief Part of the parsed source.
+     */
+    struct Span
+    {
+        /// Start position (in bytes).
+        size_t pos;
+
+        /// Length (in bytes).
+        size_t length;
+    };
+
+
     /**
      * @brief Represents cmake command.
+     *
+     * Command doesn't own any memory. Name is an interned symbol (in lower
+     * case) and arguments are stored in one pool shared by all commands
+     * as positions in the parsed source. They're converted into strings
+     * only on request.
+     *
+     * @see CMakeParser::GetName
+     * @see CMakeParser::GetArguments
      */
     struct Command
     {
-        /// Command start position.
-        wxString::size_type pos;
+        /// Command start position (in bytes).
+        size_t pos;
+
+        /// Command length in bytes (including closing parenthesis).
+        size_t length;
+
+        /// Command name symbol (lower case).
+        CMakeSymbols::Id name;
+
+        /// Index of the first argument in the arguments pool.
+        size_t firstArgument;
+
+        /// Number of arguments.
+        size_t argumentCount;
+    };
+
+
+    /**
+     * @brief Reference to a variable.
+     *
+     * Definitions are names set by set() and option(), uses are
+     * ${NAME} references in quoted and unquoted arguments.
+     */
+    struct Reference
+    {
+        /// Variable name position (in bytes).
+        size_t pos;
+
+        /// Variable name length (in bytes).
+        size_t length;
 
-        /// Command name.
-        wxString name;
+        /// Variable symbol (case sensitive).
+        CMakeSymbols::Id name;
 
-        /// Command call arguments.
-        wxArrayString arguments;
+        /// If the reference defines the variable.
+        bool definition;
     };
 
 
@@ -91,8 +157,8 @@ public:
      */
     struct Error
     {
-        /// Error position.
-        wxString::size_type pos;
+        /// Error position (in bytes).
+        size_t pos;
 
         /// Error code.
         ErrorCode code;
@@ -133,16 +199,138 @@ public:
     }
 
 
+    /**
+     * @brief Returns the last parsed source.
+     *
+     * @return
+     */
+    wxString GetContent() const {
+        return wxString::FromUTF8(m_data, m_size);
+    }
+
+
+    /**
+     * @brief Returns raw UTF-8 data of the last parsed source.
+     *
+     * Data are valid until the next parsing.
+     *
+     * @return
+     */
+    const char* GetData() const {
+        return m_data;
+    }
+
+
+    /**
+     * @brief Returns size of the last parsed source in bytes.
+     *
+     * @return
+     */
+    size_t GetSize() const {
+        return m_size;
+    }
+
+
+    /**
+     * @brief Returns source text of given span.
+     *
+     * @param span Part of the last parsed source.
+     *
+     * @return
+     */
+    wxString GetText(const Span& span) const {
+        return wxString::FromUTF8(m_data + span.pos, span.length);
+    }
+
+
+    /**
+     * @brief Returns command name.
+     *
+     * @param command Parsed command.
+     *
+     * @return
+     */
+    const wxString& GetName(const Command& command) const {
+        return CMakeSymbols::Get().GetName(command.name);
+    }
+
+
+    /**
+     * @brief Returns position of command argument.
+     *
+     * @param command Parsed command.
+     * @param index   Argument index.
+     *
+     * @return
+     */
+    const Span& GetArgumentSpan(const Command& command, size_t index) const {
+        return m_arguments[command.firstArgument + index];
+    }
+
+
+    /**
+     * @brief Returns command argument.
+     *
+     * @param command Parsed command.
+     * @param index   Argument index.
+     *
+     * @return
+     */
+    wxString GetArgument(const Command& command, size_t index) const {
+        return GetText(GetArgumentSpan(command, index));
+    }
+
+
+    /**
+     * @brief Returns all command arguments.
+     *
+     * @param command Parsed command.
+     *
+     * @return
+     */
+    wxArrayString GetArguments(const Command& command) const;
+
+
+    /**
+     * @brief Returns errors found in the last parsed source.
+     *
+     * @return Errors ordered by position.
+     */
+    const wxVector<Error>& GetErrors() const {
+        return m_errors;
+    }
+
+
     /**
      * @brief Returns defined variables.
      *
-     * @return Variables.
+     * @return Sorted symbols of variables.
      */
-    const std::set<wxString>& GetVariables() const {
+    const wxVector<CMakeSymbols::Id>& GetVariables() const {
         return m_variables;
     }
 
 
+    /**
+     * @brief Checks if variable is defined.
+     *
+     * @param name Variable symbol.
+     *
+     * @return
+     */
+    bool HasVariable(CMakeSymbols::Id name) const;
+
+
+    /**
+     * @brief Returns variable references found in the last parsed source.
+     *
+     * @return References ordered by position.
+     */
+    const wxVector<Reference>& GetReferences() const {
+        return m_references;
+    }
+
+
 // Public Operations
 public:
 
@@ -153,6 +341,16 @@ public:
     void Clear();
 
 
+    /**
+     * @brief Releases the parsed source (unmaps the file) and keeps
+     * parsed commands, variables, references and errors.
+     *
+     * Text of commands and arguments cannot be read after this call
+     * and the parser cannot be updated.
+     */
+    void ReleaseSource();
+
+
     /**
      * @brief Parses given CMakeFileLists.txt.
      *
@@ -166,11 +364,48 @@ public:
     /**
      * @brief Parses given CMakeFileLists.txt.
      *
+     * File is mapped into memory and its UTF-8 content is parsed
+     * directly, without reading it into a string.
+     *
      * @param filename Path to the parsed CMakeFileLists.txt.
+     * @param cache    Optional cache of parsed files. Unchanged file is
+     *                 not tokenized and the result is taken from it.
      *
      * @return Result of the parsing.
      */
-    bool ParseFile(const wxFileName& filename);
+    bool ParseFile(const wxFileName& filename, CMakeParseCache* cache = NULL);
+
+
+    /**
+     * @brief Applies an edit to the parsed source and reparses only
+     * affected commands.
+     *
+     * Parsing starts at the end of the command preceding the edit and
+     * stops when it reaches an unchanged command. Following commands
+     * and errors are only shifted.
+     *
+     * @param pos     Edit position (in bytes).
+     * @param removed Number of removed bytes.
+     * @param text    Inserted UTF-8 text.
+     * @param length  Length of inserted text (in bytes).
+     *
+     * @return If the edit was applied.
+     */
+    bool Update(size_t pos, size_t removed, const char* text, size_t length);
+
+
+    /**
+     * @brief Applies an edit to the parsed source.
+     *
+     * @param pos     Edit position (in bytes).
+     * @param removed Number of removed bytes.
+     * @param text    Inserted text.
+     *
+     * @return If the edit was applied.
+     *
+     * @see Update(size_t, size_t, const char*, size_t)
+     */
+    bool Update(size_t pos, size_t removed, const wxString& text);
 
 
     /**
@@ -183,6 +418,57 @@ public:
     static wxString GetError(ErrorCode code);
 
 
+// Friends
+private:
+
+
+    /// Cache stores and restores parsed data.
+    friend class CMakeParseCache;
+
+
+// Private Operations
+private:
+
+
+    /**
+     * @brief Parses the current source (m_data, m_size).
+     *
+     * @return Result of the parsing.
+     */
+    bool ParseData();
+
+
+    /**
+     * @brief Checks parsed command and stores defined variables.
+     *
+     * @param command    Parsed command.
+     * @param arguments  Arguments pool of the command.
+     * @param references Output variable references.
+     * @param errors     Output errors.
+     */
+    void CheckCommand(const Command& command, const wxVector<Span>& arguments,
+                      wxVector<Reference>& references, wxVector<Error>& errors);
+
+
+    /**
+     * @brief Finds ${NAME} references in the argument.
+     *
+     * @param span       Argument position.
+     * @param references Output variable references.
+     */
+    void FindReferences(const Span& span, wxVector<Reference>& references) const;
+
+
+    /**
+     * @brief Checks if any command defines the variable.
+     *
+     * @param name Variable symbol.
+     *
+     * @return
+     */
+    bool IsDefined(CMakeSymbols::Id name) const;
+
+
 // Private Data Members
 private:
 
@@ -190,15 +476,37 @@ private:
     /// Last parsed file.
     wxFileName m_filename;
 
+    /// UTF-8 source when string is parsed.
+    wxCharBuffer m_buffer;
+
+    /// Mapped file when file is parsed.
+    CMakeMappedFile m_file;
+
+    /// Last parsed source (points into m_buffer or m_file).
+    const char* m_data;
+
+    /// Size of the last parsed source.
+    size_t m_size;
+
     /// Parsed commands.
     wxVector<Command> m_commands;
 
-    /// Defined variables.
-    std::set<wxString> m_variables;
+    /// Arguments of all commands.
+    wxVector<Span> m_arguments;
+
+
+    /// Defined variables (sorted symbols).
+    wxVector<CMakeSymbols::Id> m_variables;
+
+    /// Variable references.
+    wxVector<Reference> m_references;
 
     /// Errors found in the last parsed source.
     wxVector<Error> m_errors;
 
+    /// Names interned by the parser.
+    mutable CMakeSymbolCache m_symbols;
+
 };
 
 /* ************************************************************************ */
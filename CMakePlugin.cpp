@@ -25,6 +25,9 @@
 // Declaration
 #include "CMakePlugin.h"
 
+// C++
+#include <algorithm>
+
 // wxWidgets
 #include <wx/app.h>
 #include <wx/stdpaths.h>
@@ -35,6 +38,11 @@
 #include <wx/dir.h>
 #include <wx/event.h>
 #include <wx/busyinfo.h>
+#include <wx/choicdlg.h>
+#include <wx/utils.h>
+#include <wx/fswatcher.h>
+#include <wx/log.h>
+#include <wx/filefn.h>
 
 // CodeLite
 #include "environmentconfig.h"
@@ -64,6 +72,11 @@
 #include "CMakeProjectSettingsPanel.h"
 #include "CMakeGenerator.h"
 #include "CMakeHelpTab.h"
+#include "CMakeAnalyzer.h"
+#include "CMakeParseCache.h"
+#include "CMakeMappedFile.h"
+#include "CMakeFileWriter.h"
+#include "CMakeCoreHost.h"
 
 /* ************************************************************************ */
 /* VARIABLES                                                                */
@@ -79,6 +92,12 @@ const wxString CMakePlugin::CMAKELISTS_FILE = "CMakeLists.txt";
 
 static const wxString HELP_TAB_NAME = "CMake Help";
 
+/* ************************************************************************ */
+/* DEFINITIONS                                                              */
+/* ************************************************************************ */
+
+wxDEFINE_EVENT(EVT_VARIABLE_INDEX_DONE, wxThreadEvent);
+
 /* ************************************************************************ */
 /* FUNCTIONS                                                                */
 /* ************************************************************************ */
@@ -132,6 +151,26 @@ extern "C" EXPORT int GetPluginInterfaceVersion()
 
 /* ************************************************************************ */
 
+/**
+ * @brief Returns generator used by project.
+ *
+ * @param settings      Project settings.
+ * @param configuration CMakePlugin global configuration.
+ *
+ * @return Generator name or empty string.
+ */
+static wxString GetGenerator(const CMakeProjectSettings& settings,
+                             const CMakeConfiguration& configuration)
+{
+    // Use global value
+    if (settings.generator.IsEmpty())
+        return configuration.GetDefaultGenerator();
+
+    return settings.generator;
+}
+
+/* ************************************************************************ */
+
 /**
  * @brief Join arguments for project settings.
  *
@@ -148,11 +187,7 @@ static wxString CreateArguments(const CMakeProjectSettings& settings,
     wxArrayString args;
 
     // Get generator
-    wxString generator = settings.generator;
-
-    // Use global value
-    if (generator.IsEmpty())
-        generator = configuration.GetDefaultGenerator();
+    const wxString generator = GetGenerator(settings, configuration);
 
     // Generator
     if (!generator.IsEmpty())
@@ -170,17 +205,143 @@ static wxString CreateArguments(const CMakeProjectSettings& settings,
     return wxJoin(args, ' ', '\0');
 }
 
+/* ************************************************************************ */
+
+/**
+ * @brief Orders locations by file and position.
+ *
+ * @param lhs
+ * @param rhs
+ *
+ * @return
+ */
+static bool CompareLocations(const CMakeVariableIndex::Location& lhs,
+                             const CMakeVariableIndex::Location& rhs)
+{
+    if (lhs.file != rhs.file)
+        return lhs.file < rhs.file;
+
+    return lhs.pos < rhs.pos;
+}
+
 /* ************************************************************************ */
 /* CLASSES                                                                  */
 /* ************************************************************************ */
 
+/**
+ * @brief Stops the analyzer when the variable index build is stopped.
+ *
+ * The flag is checked by analyzer workers, so it's guarded by the lock.
+ */
+class VariableIndexStop : public CMakeAnalyzer::StopRequest
+{
+public:
+
+
+    /**
+     * @brief Constructor.
+     *
+     * @param lock Lock of the flag.
+     * @param stop Stop flag.
+     */
+    VariableIndexStop(wxCriticalSection& lock, const bool& stop)
+        : m_lock(lock)
+        , m_stop(stop)
+    {}
+
+
+    /**
+     * @brief Checks if analysis should be stopped.
+     *
+     * @return
+     */
+    virtual bool RequestStop() const
+    {
+        wxCriticalSectionLocker locker(m_lock);
+        return m_stop;
+    }
+
+
+private:
+
+    /// Lock of the flag.
+    wxCriticalSection& m_lock;
+
+    /// Stop flag.
+    const bool& m_stop;
+};
+
+/* ************************************************************************ */
+
+/**
+ * @brief Core host which uses CodeLite's logger and ProcUtils.
+ */
+class PluginCoreHost : public CMakeCoreHost
+{
+public:
+
+
+    /**
+     * @brief Logs a message into CodeLite's log.
+     *
+     * @param level   Message level.
+     * @param message Message text.
+     */
+    virtual void Log(LogLevel level, const wxString& message)
+    {
+        switch (level)
+        {
+        case LOG_ERROR:
+            CL_ERROR("%s", message);
+            break;
+
+        case LOG_WARNING:
+            CL_WARNING("%s", message);
+            break;
+
+        case LOG_DEBUG:
+            CL_DEBUG("%s", message);
+            break;
+        }
+    }
+
+
+    /**
+     * @brief Runs a command by ProcUtils.
+     *
+     * @param command Command line.
+     * @param output  Output lines.
+     */
+    virtual void Execute(const wxString& command, wxArrayString& output)
+    {
+        ProcUtils::SafeExecuteCommand(command, output);
+    }
+
+};
+
+/* ************************************************************************ */
+
+/// Core host used while the plugin is loaded.
+static PluginCoreHost g_coreHost;
+
+/* ************************************************************************ */
+
 CMakePlugin::CMakePlugin(IManager* manager)
     : IPlugin(manager)
     , m_configuration(NULL)
     , m_cmake(NULL)
     , m_settingsManager(new CMakeSettingsManager(this))
     , m_panel(NULL)
+    , m_parseCache(new CMakeParseCache())
+    , m_variableIndex(new CMakeVariableIndex())
+    , m_variableIndexReady(false)
+    , m_variableIndexBuild(0)
+    , m_variableIndexCommand(wxID_NONE)
+    , m_variableIndexStop(false)
 {
+    // Core logs and runs commands through CodeLite
+    CMakeCoreHost::Set(&g_coreHost);
+
     m_longName = _("CMake integration with CodeLite");
     m_shortName = "CMakePlugin";
 
@@ -191,6 +352,7 @@ CMakePlugin::CMakePlugin(IManager* manager)
 
     // Create cmake application
     m_cmake.reset(new CMake(m_configuration->GetProgramPath()));
+    m_cmake->SetLazy(m_configuration->IsHelpLazy());
 
     Notebook* book = m_mgr->GetWorkspacePaneNotebook();
     if (IsPaneDetached()) {
@@ -207,13 +369,168 @@ CMakePlugin::CMakePlugin(IManager* manager)
     EventNotifier::Get()->Bind(wxEVT_GET_IS_PLUGIN_MAKEFILE, clBuildEventHandler(CMakePlugin::OnGetIsPluginMakefile), this);
     EventNotifier::Get()->Bind(wxEVT_PLUGIN_EXPORT_MAKEFILE, clBuildEventHandler(CMakePlugin::OnExportMakefile), this);
     EventNotifier::Get()->Bind(wxEVT_WORKSPACE_LOADED, wxCommandEventHandler(CMakePlugin::OnWorkspaceLoaded), this);
+    EventNotifier::Get()->Bind(wxEVT_WORKSPACE_CLOSED, wxCommandEventHandler(CMakePlugin::OnWorkspaceClosed), this);
+    EventNotifier::Get()->Bind(wxEVT_FILE_SAVED, clCommandEventHandler(CMakePlugin::OnFileSaved), this);
+
+    // Watcher sends events to the plugin
+    Bind(wxEVT_FSWATCHER, &CMakePlugin::OnFileSystemChanged, this);
+
+    // Variable index thread too
+    Bind(EVT_VARIABLE_INDEX_DONE, &CMakePlugin::OnVariableIndexDone, this);
 }
 
 /* ************************************************************************ */
 
 CMakePlugin::~CMakePlugin()
 {
-    // Nothing to do
+    CMakeCoreHost::Set(NULL);
+}
+
+/* ************************************************************************ */
+
+bool
+CMakePlugin::RequireVariableIndex(int command)
+{
+    if (m_variableIndexReady)
+        return true;
+
+    const Workspace* workspace = m_mgr->GetWorkspace();
+
+    // Nothing to index
+    if (!workspace)
+        return true;
+
+    // Repeat the command when the index is built
+    m_variableIndexCommand = command;
+
+    // Already building
+    if (m_newVariableIndex)
+        return false;
+
+    // Workspace and project root files, workspace cannot be accessed
+    // from the thread
+    m_variableIndexRoots.Clear();
+
+    wxFileName root = GetWorkspaceDirectory();
+    root.SetFullName(CMAKELISTS_FILE);
+    m_variableIndexRoots.Add(root.GetFullPath());
+
+    wxArrayString projects;
+    workspace->GetProjectList(projects);
+
+    for (wxArrayString::const_iterator it = projects.begin(),
+        ite = projects.end(); it != ite; ++it) {
+        root = GetProjectDirectory(*it);
+        root.SetFullName(CMAKELISTS_FILE);
+        m_variableIndexRoots.Add(root.GetFullPath());
+    }
+
+    m_newVariableIndex.reset(new CMakeVariableIndex());
+    m_variableIndexSaved.Clear();
+    m_variableIndexStop = false;
+    ++m_variableIndexBuild;
+
+    // Create a new joinable thread
+    if (CreateThread(wxTHREAD_JOINABLE) != wxTHREAD_NO_ERROR ||
+        GetThread()->Run() != wxTHREAD_NO_ERROR) {
+        CL_ERROR("CMake: unable to run variable index thread");
+        m_newVariableIndex.reset();
+        m_variableIndexCommand = wxID_NONE;
+        return false;
+    }
+
+    CL_DEBUG("CMake: building variable index");
+
+    return false;
+}
+
+/* ************************************************************************ */
+
+void
+CMakePlugin::StopVariableIndex()
+{
+    // Joinable thread is waited for, the analyzer stops before parsing
+    // the next file
+    if (GetThread() && GetThread()->IsRunning()) {
+        {
+            wxCriticalSectionLocker locker(m_variableIndexLock);
+            m_variableIndexStop = true;
+        }
+
+        GetThread()->Delete();
+    }
+
+    // Event of the stopped build is ignored
+    ++m_variableIndexBuild;
+
+    m_newVariableIndex.reset();
+    m_variableIndexCommand = wxID_NONE;
+    m_variableIndexSaved.Clear();
+}
+
+/* ************************************************************************ */
+
+void
+CMakePlugin::UpdateVariableIndex(const wxFileName& filename)
+{
+    CMakeParser parser;
+
+    if (parser.ParseFile(filename, m_parseCache.get()))
+        m_variableIndex->Update(parser);
+    else
+        m_variableIndex->Remove(filename.GetFullPath());
+}
+
+/* ************************************************************************ */
+
+wxThread::ExitCode
+CMakePlugin::Entry()
+{
+    // Members are not changed by the main thread until it's done
+    const int build = m_variableIndexBuild;
+    CMakeVariableIndex& index = *m_newVariableIndex;
+
+    // Results of the last session
+    if (!m_parseCache->GetCount())
+        m_parseCache->Load(GetParseCacheFileName());
+
+    const VariableIndexStop stop(m_variableIndexLock, m_variableIndexStop);
+
+    CMakeAnalyzer analyzer;
+    analyzer.SetCache(m_parseCache.get());
+    analyzer.SetStopRequest(&stop);
+
+    for (wxArrayString::const_iterator it = m_variableIndexRoots.begin(),
+        ite = m_variableIndexRoots.end(); it != ite; ++it) {
+        // Workspace was closed
+        if (GetThread()->TestDestroy())
+            return static_cast<wxThread::ExitCode>(0);
+
+        // Missing or already indexed as a part of other project
+        if (!wxFileName::FileExists(*it) || index.HasFile(*it))
+            continue;
+
+        analyzer.Analyze(*it);
+
+        // Stopped in the middle of the project
+        if (stop.RequestStop())
+            return static_cast<wxThread::ExitCode>(0);
+
+        for (size_t i = 0; i < analyzer.GetFileCount(); ++i) {
+            const CMakeAnalyzer::File& file = analyzer.GetFile(i);
+
+            if (file.parsed)
+                index.Update(file.parser);
+        }
+    }
+
+    m_parseCache->Save(GetParseCacheFileName());
+
+    wxThreadEvent event(EVT_VARIABLE_INDEX_DONE);
+    event.SetInt(build);
+    AddPendingEvent(event);
+
+    return static_cast<wxThread::ExitCode>(0);
 }
 
 /* ************************************************************************ */
@@ -307,9 +624,22 @@ CMakePlugin::GetSupportedGenerators() const
 #else
     // Linux / Mac supported generators
     generators.Add("Unix Makefiles");
-    //generators.Add("Ninja");
 #endif
 
+    // Ninja is offered only when it's installed, cmake doesn't
+    // bundle it and configuration would fail without it
+#ifdef __WXMSW__
+    const wxString ninja = "ninja.exe";
+#else
+    const wxString ninja = "ninja";
+#endif
+
+    wxPathList paths;
+    paths.AddEnvList("PATH");
+
+    if (!paths.FindAbsoluteValidPath(ninja).IsEmpty())
+        generators.Add("Ninja");
+
     return generators;
 }
 
@@ -348,6 +678,8 @@ CMakePlugin::CreatePluginMenu(wxMenu* pluginsMenu)
     pluginsMenu->Append(wxID_ANY, "CMake", menu);
 
     wxTheApp->Bind(wxEVT_COMMAND_MENU_SELECTED, &CMakePlugin::OnSettings, this, XRCID("cmake_settings"));
+    wxTheApp->Bind(wxEVT_COMMAND_MENU_SELECTED, &CMakePlugin::OnGoToDefinition, this, XRCID("cmake_goto_definition"));
+    wxTheApp->Bind(wxEVT_COMMAND_MENU_SELECTED, &CMakePlugin::OnFindReferences, this, XRCID("cmake_find_references"));
 }
 
 /* ************************************************************************ */
@@ -366,6 +698,14 @@ CMakePlugin::HookPopupMenu(wxMenu* menu, MenuType type)
             menu->PrependSeparator();
             menu->Prepend(XRCID("cmake_workspace_menu"), _("CMake"), new CMakeWorkspaceMenu(this));
         }
+    } else if (type == MenuTypeEditor) {
+        IEditor* editor = m_mgr->GetActiveEditor();
+
+        if (editor && IsCMakeFile(editor->GetFileName()) && !menu->FindItem(XRCID("cmake_goto_definition"))) {
+            menu->PrependSeparator();
+            menu->Prepend(XRCID("cmake_find_references"), _("Find CMake Variable References"));
+            menu->Prepend(XRCID("cmake_goto_definition"), _("Go to CMake Variable Definition"));
+        }
     }
 }
 
@@ -449,6 +789,8 @@ CMakePlugin::UnPlug()
 
     // Unbind events
     wxTheApp->Unbind(wxEVT_COMMAND_MENU_SELECTED, &CMakePlugin::OnSettings, this, XRCID("cmake_settings"));
+    wxTheApp->Unbind(wxEVT_COMMAND_MENU_SELECTED, &CMakePlugin::OnGoToDefinition, this, XRCID("cmake_goto_definition"));
+    wxTheApp->Unbind(wxEVT_COMMAND_MENU_SELECTED, &CMakePlugin::OnFindReferences, this, XRCID("cmake_find_references"));
 
     EventNotifier::Get()->Unbind(wxEVT_CMD_PROJ_SETTINGS_SAVED, wxCommandEventHandler(CMakePlugin::OnSaveConfig), this);
     EventNotifier::Get()->Unbind(wxEVT_GET_PROJECT_BUILD_CMD, clBuildEventHandler(CMakePlugin::OnGetBuildCommand), this);
@@ -456,17 +798,32 @@ CMakePlugin::UnPlug()
     EventNotifier::Get()->Unbind(wxEVT_GET_IS_PLUGIN_MAKEFILE, clBuildEventHandler(CMakePlugin::OnGetIsPluginMakefile), this);
     EventNotifier::Get()->Unbind(wxEVT_PLUGIN_EXPORT_MAKEFILE, clBuildEventHandler(CMakePlugin::OnExportMakefile), this);
     EventNotifier::Get()->Unbind(wxEVT_WORKSPACE_LOADED, wxCommandEventHandler(CMakePlugin::OnWorkspaceLoaded), this);
+    EventNotifier::Get()->Unbind(wxEVT_WORKSPACE_CLOSED, wxCommandEventHandler(CMakePlugin::OnWorkspaceClosed), this);
+    EventNotifier::Get()->Unbind(wxEVT_FILE_SAVED, clCommandEventHandler(CMakePlugin::OnFileSaved), this);
+
+    Unbind(wxEVT_FSWATCHER, &CMakePlugin::OnFileSystemChanged, this);
+    Unbind(EVT_VARIABLE_INDEX_DONE, &CMakePlugin::OnVariableIndexDone, this);
+
+    // Thread uses the parse cache
+    StopVariableIndex();
+
+    // Watcher requires event loop, don't wait for destructor
+    m_watcher.reset();
+    m_directories.Clear();
 }
 
 /* ************************************************************************ */
 
 bool
-CMakePlugin::ExistsCMakeLists(wxFileName directory) const
+CMakePlugin::ExistsCMakeLists(wxFileName directory)
 {
+    // Watched directory is listed only once
+    WatchDirectory(directory.GetPath());
+
     // Add CMakeLists.txt
     directory.SetFullName(CMAKELISTS_FILE);
 
-    return directory.Exists();
+    return m_directories.Exists(directory);
 }
 
 /* ************************************************************************ */
@@ -490,12 +847,15 @@ CMakePlugin::OnSettings(wxCommandEvent& event)
     // Set original value
     dlg.SetCMakePath(m_configuration->GetProgramPath());
     dlg.SetDefaultGenerator(m_configuration->GetDefaultGenerator());
+    dlg.SetHelpLazy(m_configuration->IsHelpLazy());
 
     // Store change
     if (dlg.ShowModal() == wxID_OK) {
         m_configuration->SetProgramPath(dlg.GetCMakePath());
         m_configuration->SetDefaultGenerator(dlg.GetDefaultGenerator());
+        m_configuration->SetHelpLazy(dlg.IsHelpLazy());
         m_cmake->SetPath(dlg.GetCMakePath());
+        m_cmake->SetLazy(dlg.IsHelpLazy());
     }
 }
 
@@ -650,23 +1010,50 @@ CMakePlugin::OnExportMakefile(clBuildEvent& event)
         const wxString sourceDirEsc = sourceDir.GetPath(wxPATH_NO_SEPARATOR, wxPATH_UNIX);
         const wxString buildDirEsc = buildDir.GetPath(wxPATH_NO_SEPARATOR, wxPATH_UNIX);
 
+        // Ninja has its own build file and it's not called by make
+        const bool ninja = GetGenerator(*settings, *m_configuration.get()) == "Ninja";
+
         // Generated makefile
         content <<
             "CMAKE      := \"" << cmake << "\"\n"
             "BUILD_DIR  := " << buildDirEsc << "\n"
+            "BUILD_FILE := $(BUILD_DIR)/" << (ninja ? "build.ninja" : "Makefile") << "\n"
             "SOURCE_DIR := " << sourceDirEsc << "\n"
             "CMAKE_ARGS := " << CreateArguments(*settings, *m_configuration.get()) << "\n"
             "\n"
-            "# Building project(s)\n"
-            "$(or $(lastword $(MAKECMDGOALS)), all): $(BUILD_DIR)/Makefile\n"
-            "\t$(MAKE) -C \"$(BUILD_DIR)\" $(MAKECMDGOALS)\n"
-            "\n"
+        ;
+
+        if (ninja) {
+            // Ninja cleans single targets by its clean tool. Note that
+            // "-t clean <target>" removes all files built for the target
+            // including its dependencies (e.g. libraries of other projects
+            // in the workspace), not only the target's own outputs.
+            content <<
+                "# Ninja targets\n"
+                "NINJA_GOALS := $(if $(and $(filter clean,$(MAKECMDGOALS)),$(filter-out clean,$(MAKECMDGOALS))),"
+                    "-t clean $(filter-out clean,$(MAKECMDGOALS)),$(MAKECMDGOALS))\n"
+                "\n"
+                "# Building project(s)\n"
+                "$(or $(lastword $(MAKECMDGOALS)), all): $(BUILD_FILE)\n"
+                "\t$(CMAKE) --build \"$(BUILD_DIR)\" -- $(NINJA_GOALS)\n"
+                "\n"
+            ;
+        } else {
+            content <<
+                "# Building project(s)\n"
+                "$(or $(lastword $(MAKECMDGOALS)), all): $(BUILD_FILE)\n"
+                "\t$(MAKE) -C \"$(BUILD_DIR)\" $(MAKECMDGOALS)\n"
+                "\n"
+            ;
+        }
+
+        content <<
             "# Building directory\n"
             "$(BUILD_DIR):\n"
             "\t$(CMAKE) -E make_directory \"$(BUILD_DIR)\"\n"
             "\n"
             "# Rule that detects if cmake is called\n"
-            "$(BUILD_DIR)/Makefile: .cmake_dirty | $(BUILD_DIR)\n"
+            "$(BUILD_FILE): .cmake_dirty | $(BUILD_DIR)\n"
             "\tcd \"$(BUILD_DIR)\" && $(CMAKE) $(CMAKE_ARGS) \"$(SOURCE_DIR)\"\n"
             "\n"
             "# This rule / file allows force cmake run\n"
@@ -682,18 +1069,17 @@ CMakePlugin::OnExportMakefile(clBuildEvent& event)
     makefile.SetName(project);
     makefile.SetExt("mk");
 
-    // Read old content from disk
-    wxString oldContent;
-    bool ok = ReadFileWithConversion(makefile.GetFullPath(), oldContent);
+    // Writer keeps the makefile untouched if there are no changes
+    CMakeFileWriter output;
+    bool ok = output.Open(makefile);
 
-    // Write only if there are some changes
-    if (!ok || content != oldContent) {
-        // Write make file content
-        wxFile file(makefile.GetFullPath(), wxFile::write);
+    if (ok) {
+        output << content;
+        ok = output.Commit();
+    }
 
-        if (!file.Write(content)) {
-            CL_ERROR("Unable to write custom makefile (CMakePlugin): " + makefile.GetFullPath());
-        }
+    if (!ok) {
+        CL_ERROR("Unable to write custom makefile (CMakePlugin): " + makefile.GetFullPath());
     }
 }
 
@@ -711,6 +1097,167 @@ CMakePlugin::OnWorkspaceLoaded(wxCommandEvent& event)
 
 /* ************************************************************************ */
 
+void
+CMakePlugin::OnWorkspaceClosed(wxCommandEvent& event)
+{
+    event.Skip();
+
+    // Index of the closed workspace is not needed
+    StopVariableIndex();
+
+    // Keep parsed files for the next time
+    if (m_variableIndexReady)
+        m_parseCache->Save(GetParseCacheFileName());
+
+    m_variableIndex->Clear();
+    m_variableIndexReady = false;
+
+    // Stop watching workspace directories
+    if (m_watcher)
+        m_watcher->RemoveAll();
+
+    m_directories.Clear();
+    m_unwatched.clear();
+}
+
+/* ************************************************************************ */
+
+void
+CMakePlugin::OnFileSaved(clCommandEvent& event)
+{
+    event.Skip();
+
+    wxFileName filename(event.GetString());
+
+    if (!IsCMakeFile(filename))
+        return;
+
+    filename.MakeAbsolute();
+
+    // Thread could read the old content, file is parsed again when
+    // the index is built
+    if (m_newVariableIndex) {
+        m_variableIndexSaved.Add(filename.GetFullPath());
+        return;
+    }
+
+    // Index will be built with the current content
+    if (!m_variableIndexReady)
+        return;
+
+    // Only the saved file is parsed again
+    UpdateVariableIndex(filename);
+}
+
+/* ************************************************************************ */
+
+void
+CMakePlugin::OnGoToDefinition(wxCommandEvent& event)
+{
+    if (!RequireVariableIndex(event.GetId()))
+        return;
+
+    const CMakeSymbols::Id name = GetVariableAtCaret();
+
+    if (name == CMakeSymbols::InvalidId)
+        return;
+
+    ShowLocations(_("Definitions of ") + CMakeSymbols::Get().GetName(name),
+                  GetVariableIndex().GetDefinitions(name));
+}
+
+/* ************************************************************************ */
+
+void
+CMakePlugin::OnFindReferences(wxCommandEvent& event)
+{
+    if (!RequireVariableIndex(event.GetId()))
+        return;
+
+    const CMakeSymbols::Id name = GetVariableAtCaret();
+
+    if (name == CMakeSymbols::InvalidId)
+        return;
+
+    const CMakeVariableIndex& index = GetVariableIndex();
+
+    wxVector<CMakeVariableIndex::Location> locations = index.GetDefinitions(name);
+    const wxVector<CMakeVariableIndex::Location>& uses = index.GetUses(name);
+
+    // wxVector has no range insert
+    for (wxVector<CMakeVariableIndex::Location>::const_iterator it = uses.begin(),
+        ite = uses.end(); it != ite; ++it) {
+        locations.push_back(*it);
+    }
+
+    ShowLocations(_("References of ") + CMakeSymbols::Get().GetName(name), locations);
+}
+
+/* ************************************************************************ */
+
+void
+CMakePlugin::OnFileSystemChanged(wxFileSystemWatcherEvent& event)
+{
+    const int type = event.GetChangeType();
+
+    // Events may be lost, nothing can be trusted
+    if (type & (wxFSW_EVENT_WARNING | wxFSW_EVENT_ERROR)) {
+        CL_DEBUG("CMake: file system watcher failure, directory snapshot cleared");
+
+        if (m_watcher)
+            m_watcher->RemoveAll();
+
+        m_directories.Clear();
+        return;
+    }
+
+    if (!(type & (wxFSW_EVENT_CREATE | wxFSW_EVENT_DELETE | wxFSW_EVENT_RENAME)))
+        return;
+
+    // Changed file is in the directory, but the directory itself
+    // can be changed too (e.g. deleted)
+    m_directories.Invalidate(event.GetPath().GetPath());
+    m_directories.Invalidate(event.GetPath().GetFullPath());
+
+    if (type & wxFSW_EVENT_RENAME)
+        m_directories.Invalidate(event.GetNewPath().GetPath());
+}
+
+/* ************************************************************************ */
+
+void
+CMakePlugin::OnVariableIndexDone(wxThreadEvent& event)
+{
+    // Stopped build
+    if (event.GetInt() != m_variableIndexBuild || !m_newVariableIndex)
+        return;
+
+    // Thread is finishing
+    GetThread()->Wait();
+
+    m_variableIndex.reset(m_newVariableIndex.release());
+    m_variableIndexReady = true;
+
+    // Files saved during the build
+    for (wxArrayString::const_iterator it = m_variableIndexSaved.begin(),
+        ite = m_variableIndexSaved.end(); it != ite; ++it) {
+        UpdateVariableIndex(wxFileName(*it));
+    }
+
+    m_variableIndexSaved.Clear();
+
+    CL_DEBUG("CMake: %u files indexed", static_cast<unsigned>(m_variableIndex->GetFileCount()));
+
+    // Repeat the command that requested the index
+    if (m_variableIndexCommand != wxID_NONE) {
+        wxCommandEvent command(wxEVT_COMMAND_MENU_SELECTED, m_variableIndexCommand);
+        m_variableIndexCommand = wxID_NONE;
+        wxTheApp->AddPendingEvent(command);
+    }
+}
+
+/* ************************************************************************ */
+
 void
 CMakePlugin::ProcessBuildEvent(clBuildEvent& event, wxString param)
 {
@@ -762,3 +1309,144 @@ CMakePlugin::ProcessBuildEvent(clBuildEvent& event, wxString param)
 }
 
 /* ************************************************************************ */
+
+bool
+CMakePlugin::IsCMakeFile(const wxFileName& filename)
+{
+    return filename.GetFullName() == CMAKELISTS_FILE ||
+        filename.GetExt().IsSameAs("cmake", false);
+}
+
+/* ************************************************************************ */
+
+wxFileName
+CMakePlugin::GetParseCacheFileName()
+{
+    return wxFileName(wxStandardPaths::Get().GetUserDataDir(), "cmake-cache.db");
+}
+
+/* ************************************************************************ */
+
+void
+CMakePlugin::WatchDirectory(const wxString& directory)
+{
+    if (m_directories.IsWatched(directory) || m_unwatched.count(directory))
+        return;
+
+    if (!m_watcher) {
+        m_watcher.reset(new wxFileSystemWatcher());
+        m_watcher->SetOwner(this);
+    }
+
+    // Failure is not an error, don't bother user with it
+    wxLogNull noLog;
+
+    // Without watching the snapshot listing expires
+    if (m_watcher->Add(wxFileName::DirName(directory),
+            wxFSW_EVENT_CREATE | wxFSW_EVENT_DELETE | wxFSW_EVENT_RENAME |
+            wxFSW_EVENT_WARNING | wxFSW_EVENT_ERROR)) {
+        m_directories.SetWatched(directory);
+    } else {
+        CL_DEBUG("CMake: unable to watch '%s'", directory);
+        m_unwatched.insert(directory);
+    }
+}
+
+/* ************************************************************************ */
+
+CMakeSymbols::Id
+CMakePlugin::GetVariableAtCaret()
+{
+    IEditor* editor = m_mgr->GetActiveEditor();
+
+    if (!editor || !IsCMakeFile(editor->GetFileName()))
+        return CMakeSymbols::InvalidId;
+
+    wxFileName filename = editor->GetFileName();
+    filename.MakeAbsolute();
+
+    const CMakeVariableIndex& index = GetVariableIndex();
+
+    // Reference under caret, index knows positions of the saved content
+    const CMakeSymbols::Id name = index.Find(filename.GetFullPath(), editor->GetCurrentPosition());
+
+    if (name != CMakeSymbols::InvalidId)
+        return name;
+
+    // Word under caret, variable must be known
+    const wxString word = editor->GetWordAtCaret();
+
+    if (word.IsEmpty())
+        return CMakeSymbols::InvalidId;
+
+    return CMakeSymbols::Get().Find(word);
+}
+
+/* ************************************************************************ */
+
+void
+CMakePlugin::ShowLocations(const wxString& title,
+                           wxVector<CMakeVariableIndex::Location> locations)
+{
+    if (locations.empty()) {
+        wxMessageBox(_("No locations found in the workspace CMake files"), title, wxOK | wxCENTER | wxICON_INFORMATION);
+        return;
+    }
+
+    size_t selected = 0;
+
+    if (locations.size() > 1) {
+        const CMakeVariableIndex& index = GetVariableIndex();
+        const wxFileName workspaceDir = GetWorkspaceDirectory();
+
+        wxArrayString items;
+        CMakeMappedFile file;
+        size_t mapped = static_cast<size_t>(-1);
+
+        // Group locations by file, so each file is mapped once
+        std::sort(locations.begin(), locations.end(), CompareLocations);
+
+        for (wxVector<CMakeVariableIndex::Location>::const_iterator it = locations.begin(),
+            ite = locations.end(); it != ite; ++it) {
+            if (it->file != mapped) {
+                file.Open(index.GetPath(it->file));
+                mapped = it->file;
+            }
+
+            // Line number from the position
+            size_t line = 1;
+
+            if (file.IsOpened() && it->pos <= file.GetSize())
+                line += std::count(file.GetData(), file.GetData() + it->pos, '\n');
+
+            wxFileName path(index.GetPath(it->file));
+            path.MakeRelativeTo(workspaceDir.GetFullPath());
+
+            items.Add(wxString::Format("%s:%u", path.GetFullPath(), static_cast<unsigned>(line)));
+        }
+
+        const int choice = wxGetSingleChoiceIndex(_("Select location:"), title, items);
+
+        if (choice == wxNOT_FOUND)
+            return;
+
+        selected = choice;
+    }
+
+    const CMakeVariableIndex::Location& location = locations[selected];
+    const wxString& path = GetVariableIndex().GetPath(location.file);
+
+    if (!m_mgr->OpenFile(path)) {
+        wxMessageBox("Unable to open \"" + path + "\"", wxMessageBoxCaptionStr, wxOK | wxCENTER | wxICON_ERROR);
+        return;
+    }
+
+    IEditor* editor = m_mgr->GetActiveEditor();
+
+    if (editor) {
+        editor->CenterLine(editor->LineFromPos(location.pos));
+        editor->SelectText(location.pos, location.length);
+    }
+}
+
+/* ************************************************************************ */
@@ -25,8 +25,12 @@
 /* INCLUDES                                                                 */
 /* ************************************************************************ */
 
+// C++
+#include <set>
+
 // wxWidgets
 #include <wx/scopedptr.h>
+#include <wx/thread.h>
 
 // CodeLite
 #include "plugin.h"
@@ -36,6 +40,8 @@
 
 // CMakePlugin
 #include "CMakeConfiguration.h"
+#include "CMakeVariableIndex.h"
+#include "CMakeDirectorySnapshot.h"
 
 /* ************************************************************************ */
 /* FORWARD DECLARATIONS                                                     */
@@ -46,6 +52,9 @@ class CMakeSettingsManager;
 class CMakeProjectSettingsPanel;
 class CMakeProjectSettings;
 class CMakeGenerator;
+class CMakeParseCache;
+class wxFileSystemWatcher;
+class wxFileSystemWatcherEvent;
 
 /* ************************************************************************ */
 /* CLASSES                                                                  */
@@ -64,8 +73,10 @@ class CMakeGenerator;
  * doesn't regenerate CMake files because it's not able to detect changes.
  * For this purpose there is a button that marks configuration dirty and
  * forces plugin to regenerate CMake files.
+ *
+ * Index of workspace CMake variables is built by the plugin thread.
  */
-class CMakePlugin : public IPlugin
+class CMakePlugin : public IPlugin, public wxThreadHelper
 {
 
 // Public Constants
@@ -139,6 +150,44 @@ public:
     }
 
 
+    /**
+     * @brief Returns index of CMake variables in the workspace.
+     *
+     * Index is built in background on first request (see
+     * RequireVariableIndex) from CMakeLists.txt of the workspace and
+     * projects (and files they include) and it's updated when a CMake
+     * file is saved. It's empty until it's built.
+     *
+     * @return
+     */
+    const CMakeVariableIndex& GetVariableIndex() const {
+        return *m_variableIndex;
+    }
+
+
+    /**
+     * @brief Checks if the variable index is built.
+     *
+     * @return
+     */
+    bool IsVariableIndexReady() const {
+        return m_variableIndexReady;
+    }
+
+
+    /**
+     * @brief Returns snapshot of workspace directories.
+     *
+     * Snapshot answers file existence checks (e.g. in update UI
+     * handlers) without accessing the file system every time.
+     *
+     * @return
+     */
+    CMakeDirectorySnapshot& GetDirectorySnapshot() {
+        return m_directories;
+    }
+
+
     /**
      * @brief Returns directory where is workspace project stored.
      *
@@ -203,7 +252,8 @@ public:
      * @brief Returns a list of supported generators.
      *
      * Plugin supports only generators that generate directly buildable
-     * output like Unix Makefile or MinGW Makefile.
+     * output like Unix Makefile, MinGW Makefile or Ninja. Ninja is
+     * included only if it's found in PATH.
      *
      * @return List.
      */
@@ -280,11 +330,14 @@ public:
     /**
      * @brief Check if CMakeLists.txt exists in given directory.
      *
+     * Directory is watched for changes and the result is answered from
+     * the directory snapshot, so repeated checks don't access the disk.
+     *
      * @param directory Directory where CMakeLists.txt should be located.
      *
      * @return If CMakeLists.txt exists in directory.
      */
-    bool ExistsCMakeLists(wxFileName directory) const;
+    bool ExistsCMakeLists(wxFileName directory);
 
 
     /**
@@ -353,6 +406,67 @@ public:
     void OnWorkspaceLoaded(wxCommandEvent& event);
 
 
+    /**
+     * @brief On workspace is closed.
+     *
+     * @param event
+     */
+    void OnWorkspaceClosed(wxCommandEvent& event);
+
+
+    /**
+     * @brief On file is saved, updates variable index.
+     *
+     * @param event
+     */
+    void OnFileSaved(clCommandEvent& event);
+
+
+    /**
+     * @brief Jumps to definition of variable under caret.
+     *
+     * @param event
+     */
+    void OnGoToDefinition(wxCommandEvent& event);
+
+
+    /**
+     * @brief Lists definitions and uses of variable under caret.
+     *
+     * @param event
+     */
+    void OnFindReferences(wxCommandEvent& event);
+
+
+    /**
+     * @brief On change in a watched directory, invalidates its snapshot.
+     *
+     * @param event
+     */
+    void OnFileSystemChanged(wxFileSystemWatcherEvent& event);
+
+
+    /**
+     * @brief On variable index is built by the thread, publishes it
+     * and repeats the command that requested it.
+     *
+     * @param event
+     */
+    void OnVariableIndexDone(wxThreadEvent& event);
+
+
+// wxThreadHelper
+protected:
+
+
+    /**
+     * @brief Thread entry, builds the variable index.
+     *
+     * @return
+     */
+    virtual wxThread::ExitCode Entry();
+
+
 // Private Operations
 private:
 
@@ -366,6 +480,80 @@ private:
     void ProcessBuildEvent(clBuildEvent& event, wxString param = "");
 
 
+    /**
+     * @brief Checks if file is a CMake file (CMakeLists.txt or *.cmake).
+     *
+     * @param filename
+     *
+     * @return
+     */
+    static bool IsCMakeFile(const wxFileName& filename);
+
+
+    /**
+     * @brief Returns path of the parse cache database.
+     *
+     * @return
+     */
+    static wxFileName GetParseCacheFileName();
+
+
+    /**
+     * @brief Starts watching the directory for created and deleted files.
+     *
+     * Watcher is created on first use because it requires running
+     * event loop.
+     *
+     * @param directory Directory path.
+     */
+    void WatchDirectory(const wxString& directory);
+
+
+    /**
+     * @brief Checks if the variable index is ready. If it isn't,
+     * starts building it in background and the command is repeated
+     * when the index is ready.
+     *
+     * @param command Menu command ID.
+     *
+     * @return If index is ready.
+     */
+    bool RequireVariableIndex(int command);
+
+
+    /**
+     * @brief Stops building of the variable index and waits for the thread.
+     */
+    void StopVariableIndex();
+
+
+    /**
+     * @brief Parses the file again and updates it in the variable index.
+     *
+     * @param filename Absolute path to the file.
+     */
+    void UpdateVariableIndex(const wxFileName& filename);
+
+
+    /**
+     * @brief Returns variable under caret of the active editor.
+     *
+     * @return Variable symbol or CMakeSymbols::InvalidId.
+     */
+    CMakeSymbols::Id GetVariableAtCaret();
+
+
+    /**
+     * @brief Opens the location or lets user choose one if there are more.
+     *
+     * @param title     Choice dialog title.
+     * @param locations Locations from the variable index (sorted by file
+     *                  and position for the choice).
+     */
+    void ShowLocations(const wxString& title,
+                       wxVector<CMakeVariableIndex::Location> locations);
+
+
 // Private Data Members
 private:
 
@@ -382,6 +570,45 @@ private:
     /// Only one is enough
     CMakeProjectSettingsPanel* m_panel;
 
+    /// Cache of parsed CMake files.
+    wxScopedPtr<CMakeParseCache> m_parseCache;
+
+    /// Index of variables in workspace CMake files.
+    wxScopedPtr<CMakeVariableIndex> m_variableIndex;
+
+    /// If the variable index is built.
+    bool m_variableIndexReady;
+
+    /// Index being built by the thread.
+    wxScopedPtr<CMakeVariableIndex> m_newVariableIndex;
+
+    /// Root CMakeLists.txt files indexed by the thread.
+    wxArrayString m_variableIndexRoots;
+
+    /// Build of the index, events of stopped builds are ignored.
+    int m_variableIndexBuild;
+
+    /// Command repeated when the index is built.
+    int m_variableIndexCommand;
+
+    /// Files saved while the index was being built.
+    wxArrayString m_variableIndexSaved;
+
+    /// Guards the stop flag, it's read by analyzer workers.
+    wxCriticalSection m_variableIndexLock;
+
+    /// If the thread should stop.
+    bool m_variableIndexStop;
+
+    /// Snapshot of directories with CMakeLists.txt.
+    CMakeDirectorySnapshot m_directories;
+
+    /// Watcher of directories in the snapshot.
+    wxScopedPtr<wxFileSystemWatcher> m_watcher;
+
+    /// Directories that cannot be watched.
+    std::set<wxString> m_unwatched;
+
 };
 
 /* ************************************************************************ */
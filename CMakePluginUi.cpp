@@ -52,6 +52,12 @@ CMakeSettingsDialogBase::CMakeSettingsDialogBase(wxWindow* parent, wxWindowID id
     
     flexGridSizer->Add(m_choiceDefaultGenerator, 1, wxALL|wxEXPAND|wxALIGN_CENTER_VERTICAL, 0);
     
+    m_checkBoxLazyHelp = new wxCheckBox(this, wxID_ANY, _("Load help pages on demand"), wxDefaultPosition, wxSize(-1,-1), 0);
+    m_checkBoxLazyHelp->SetValue(true);
+    m_checkBoxLazyHelp->SetToolTip(_("Only names are loaded at startup, help pages are loaded when they are shown."));
+    
+    boxSizerMain->Add(m_checkBoxLazyHelp, 0, wxALL, 5);
+    
     m_staticLine = new wxStaticLine(this, wxID_ANY, wxDefaultPosition, wxSize(-1,-1), wxLI_HORIZONTAL);
     
     boxSizerMain->Add(m_staticLine, 0, wxALL|wxEXPAND, 5);
@@ -141,12 +147,11 @@ CMakeHelpTabBase::CMakeHelpTabBase(wxWindow* parent, wxWindowID id, const wxPoin
     boxSizerList->Add(m_searchCtrlFilter, 0, wxBOTTOM|wxEXPAND, 5);
     m_searchCtrlFilter->SetMinSize(wxSize(-1,22));
     
-    wxArrayString m_listBoxListArr;
-    m_listBoxList = new wxListBox(m_splitterPageList, wxID_ANY, wxDefaultPosition, wxSize(-1,-1), m_listBoxListArr, wxLB_SINGLE);
-    m_listBoxList->SetToolTip(_("Double click to insert in the current editor."));
+    m_listCtrlList = new CMakeHelpList(m_splitterPageList, wxID_ANY, wxDefaultPosition, wxSize(-1,-1), wxLC_REPORT|wxLC_VIRTUAL|wxLC_NO_HEADER|wxLC_SINGLE_SEL);
+    m_listCtrlList->SetToolTip(_("Double click to insert in the current editor."));
     
-    boxSizerList->Add(m_listBoxList, 1, wxALL|wxEXPAND, 0);
-    m_listBoxList->SetMinSize(wxSize(100,200));
+    boxSizerList->Add(m_listCtrlList, 1, wxALL|wxEXPAND, 0);
+    m_listCtrlList->SetMinSize(wxSize(100,200));
     
     m_splitterPageText = new wxPanel(m_splitter, wxID_ANY, wxDefaultPosition, wxSize(-1,-1), wxTAB_TRAVERSAL);
     m_splitter->SplitHorizontally(m_splitterPageList, m_splitterPageText, 100);
@@ -183,9 +188,9 @@ CMakeHelpTabBase::CMakeHelpTabBase(wxWindow* parent, wxWindowID id, const wxPoin
     m_searchCtrlFilter->Connect(wxEVT_COMMAND_SEARCHCTRL_CANCEL_BTN, wxCommandEventHandler(CMakeHelpTabBase::OnSearchCancel), NULL, this);
     m_searchCtrlFilter->Connect(wxEVT_COMMAND_TEXT_ENTER, wxCommandEventHandler(CMakeHelpTabBase::OnSearch), NULL, this);
     m_searchCtrlFilter->Connect(wxEVT_UPDATE_UI, wxUpdateUIEventHandler(CMakeHelpTabBase::OnUpdateUi), NULL, this);
-    m_listBoxList->Connect(wxEVT_COMMAND_LISTBOX_SELECTED, wxCommandEventHandler(CMakeHelpTabBase::OnSelect), NULL, this);
-    m_listBoxList->Connect(wxEVT_COMMAND_LISTBOX_DOUBLECLICKED, wxCommandEventHandler(CMakeHelpTabBase::OnInsert), NULL, this);
-    m_listBoxList->Connect(wxEVT_UPDATE_UI, wxUpdateUIEventHandler(CMakeHelpTabBase::OnUpdateUi), NULL, this);
+    m_listCtrlList->Connect(wxEVT_COMMAND_LIST_ITEM_SELECTED, wxListEventHandler(CMakeHelpTabBase::OnItemSelected), NULL, this);
+    m_listCtrlList->Connect(wxEVT_COMMAND_LIST_ITEM_ACTIVATED, wxListEventHandler(CMakeHelpTabBase::OnItemActivated), NULL, this);
+    m_listCtrlList->Connect(wxEVT_UPDATE_UI, wxUpdateUIEventHandler(CMakeHelpTabBase::OnUpdateUi), NULL, this);
     m_htmlWinText->Connect(wxEVT_UPDATE_UI, wxUpdateUIEventHandler(CMakeHelpTabBase::OnUpdateUi), NULL, this);
     
 }
@@ -203,9 +208,9 @@ CMakeHelpTabBase::~CMakeHelpTabBase()
     m_searchCtrlFilter->Disconnect(wxEVT_COMMAND_SEARCHCTRL_CANCEL_BTN, wxCommandEventHandler(CMakeHelpTabBase::OnSearchCancel), NULL, this);
     m_searchCtrlFilter->Disconnect(wxEVT_COMMAND_TEXT_ENTER, wxCommandEventHandler(CMakeHelpTabBase::OnSearch), NULL, this);
     m_searchCtrlFilter->Disconnect(wxEVT_UPDATE_UI, wxUpdateUIEventHandler(CMakeHelpTabBase::OnUpdateUi), NULL, this);
-    m_listBoxList->Disconnect(wxEVT_COMMAND_LISTBOX_SELECTED, wxCommandEventHandler(CMakeHelpTabBase::OnSelect), NULL, this);
-    m_listBoxList->Disconnect(wxEVT_COMMAND_LISTBOX_DOUBLECLICKED, wxCommandEventHandler(CMakeHelpTabBase::OnInsert), NULL, this);
-    m_listBoxList->Disconnect(wxEVT_UPDATE_UI, wxUpdateUIEventHandler(CMakeHelpTabBase::OnUpdateUi), NULL, this);
+    m_listCtrlList->Disconnect(wxEVT_COMMAND_LIST_ITEM_SELECTED, wxListEventHandler(CMakeHelpTabBase::OnItemSelected), NULL, this);
+    m_listCtrlList->Disconnect(wxEVT_COMMAND_LIST_ITEM_ACTIVATED, wxListEventHandler(CMakeHelpTabBase::OnItemActivated), NULL, this);
+    m_listCtrlList->Disconnect(wxEVT_UPDATE_UI, wxUpdateUIEventHandler(CMakeHelpTabBase::OnUpdateUi), NULL, this);
     m_htmlWinText->Disconnect(wxEVT_UPDATE_UI, wxUpdateUIEventHandler(CMakeHelpTabBase::OnUpdateUi), NULL, this);
     
 }
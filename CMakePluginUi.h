@@ -17,16 +17,17 @@
 #include <wx/filepicker.h>
 #include <wx/choice.h>
 #include <wx/arrstr.h>
+#include <wx/checkbox.h>
 #include <wx/statline.h>
 #include <wx/button.h>
 #include <wx/panel.h>
 #include <wx/radiobox.h>
 #include <wx/splitter.h>
 #include <wx/srchctrl.h>
-#include <wx/listbox.h>
+#include <wx/listctrl.h>
+#include "CMakeHelpList.h"
 #include <wx/html/htmlwin.h>
 #include <wx/gauge.h>
-#include <wx/checkbox.h>
 #include <wx/combobox.h>
 #include <wx/textctrl.h>
 
@@ -37,6 +38,7 @@ protected:
     wxFilePickerCtrl* m_filePickerProgram;
     wxStaticText* m_staticTextDefaultGenerator;
     wxChoice* m_choiceDefaultGenerator;
+    wxCheckBox* m_checkBoxLazyHelp;
     wxStaticLine* m_staticLine;
     wxStdDialogButtonSizer* m_stdBtnSizer;
     wxButton* m_buttonOk;
@@ -60,7 +62,7 @@ protected:
     wxSplitterWindow* m_splitter;
     wxPanel* m_splitterPageList;
     wxSearchCtrl* m_searchCtrlFilter;
-    wxListBox* m_listBoxList;
+    CMakeHelpList* m_listCtrlList;
     wxPanel* m_splitterPageText;
     wxHtmlWindow* m_htmlWinText;
     wxGauge* m_gaugeLoad;
@@ -72,8 +74,8 @@ protected:
     virtual void OnRightClick(wxMouseEvent& event) { event.Skip(); }
     virtual void OnSearch(wxCommandEvent& event) { event.Skip(); }
     virtual void OnSearchCancel(wxCommandEvent& event) { event.Skip(); }
-    virtual void OnSelect(wxCommandEvent& event) { event.Skip(); }
-    virtual void OnInsert(wxCommandEvent& event) { event.Skip(); }
+    virtual void OnItemSelected(wxListEvent& event) { event.Skip(); }
+    virtual void OnItemActivated(wxListEvent& event) { event.Skip(); }
 
 public:
     CMakeHelpTabBase(wxWindow* parent, wxWindowID id = wxID_ANY, const wxPoint& pos = wxDefaultPosition, const wxSize& size = wxSize(300,400), long style = wxTAB_TRAVERSAL);
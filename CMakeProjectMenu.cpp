@@ -94,10 +94,19 @@ CMakeProjectMenu::OnCMakeListsOpen(wxCommandEvent& event)
 void
 CMakeProjectMenu::OnExport(wxCommandEvent& event)
 {
+    ProjectPtr project = m_plugin->GetSelectedProject();
+
+    // No project is selected
+    if (!project)
+        return;
+
     CMakeGenerator::Generate(
-        m_plugin->GetSelectedProject(),
+        project,
         m_plugin->GetSelectedBuildConfig()
     );
+
+    // Update state of the "Open CMakeLists.txt" item
+    m_plugin->GetDirectorySnapshot().Invalidate(project->GetFileName().GetPath());
 }
 
 /* ************************************************************************ */
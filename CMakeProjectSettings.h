@@ -42,7 +42,8 @@
  * This structure stores all required data for project configuration
  * by CMake.
  *
- * @note Only "Unix Makefiles" generator is supported now.
+ * @note Only "Unix Makefiles", "MinGW Makefiles" and "Ninja" generators
+ * are supported now.
  */
 struct CMakeProjectSettings
 {
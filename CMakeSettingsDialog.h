@@ -87,6 +87,16 @@ public:
     }
 
 
+    /**
+     * @brief Returns if help pages are loaded on demand.
+     *
+     * @return
+     */
+    bool IsHelpLazy() const {
+        return m_checkBoxLazyHelp->GetValue();
+    }
+
+
 // Public Mutators
 public:
 
@@ -111,6 +121,16 @@ public:
     }
 
 
+    /**
+     * @brief Change if help pages are loaded on demand.
+     *
+     * @param lazy
+     */
+    void SetHelpLazy(bool lazy) {
+        m_checkBoxLazyHelp->SetValue(lazy);
+    }
+
+
 // Private Data Members
 private:
 
@@ -0,0 +1,333 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// Declaration
+#include "CMakeSymbols.h"
+
+// C++
+#include <cstring>
+
+// wxWidgets
+#include <wx/buffer.h>
+
+/* ************************************************************************ */
+/* VARIABLES                                                                */
+/* ************************************************************************ */
+
+const CMakeSymbols::Id CMakeSymbols::InvalidId;
+
+/// Maximum number of names in the symbol cache.
+static const size_t SYMBOL_CACHE_SIZE = 4096;
+
+/// Marks empty slot in the symbol cache.
+static const size_t EMPTY_SLOT = static_cast<size_t>(-1);
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Calculates hash of the name (FNV-1a).
+ *
+ * @param name   Name.
+ * @param length Name length.
+ *
+ * @return
+ */
+static size_t HashName(const char* name, size_t length)
+{
+    wxUint32 hash = 2166136261u;
+
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(name[i]);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Converts ASCII letters of the name to lower case.
+ *
+ * @param name   UTF-8 name.
+ * @param length Name length.
+ * @param buffer Buffer for short names.
+ * @param size   Buffer size.
+ * @param folded Storage for long names.
+ *
+ * @return Folded name (it can be the original one).
+ */
+static const char* FoldName(const char* name, size_t length, char* buffer,
+                            size_t size, std::string& folded)
+{
+    // Already lower case
+    bool lower = true;
+    for (size_t i = 0; i < length && lower; ++i) {
+        lower = !(name[i] >= 'A' && name[i] <= 'Z');
+    }
+
+    if (lower)
+        return name;
+
+    char* data = buffer;
+
+    if (length > size) {
+        folded.resize(length);
+        data = &folded[0];
+    }
+
+    for (size_t i = 0; i < length; ++i) {
+        data[i] = (name[i] >= 'A' && name[i] <= 'Z') ? name[i] - 'A' + 'a' : name[i];
+    }
+
+    return data;
+}
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+CMakeSymbols&
+CMakeSymbols::Get()
+{
+    // Created on first use
+    static CMakeSymbols s_symbols;
+    return s_symbols;
+}
+
+/* ************************************************************************ */
+
+CMakeSymbols::CMakeSymbols()
+    : m_slots(256, InvalidId)
+{
+    // Well-known names in WellKnown order
+    static const char* const names[WellKnownCount] = {
+        "set",
+        "option",
+        "list",
+        "include",
+        "add_subdirectory",
+        "find_package"
+    };
+
+    for (int i = 0; i < WellKnownCount; ++i) {
+        Intern(names[i], strlen(names[i]));
+    }
+}
+
+/* ************************************************************************ */
+
+const wxString&
+CMakeSymbols::GetName(Id id) const
+{
+    wxMutexLocker lock(m_mutex);
+    return m_names[id];
+}
+
+/* ************************************************************************ */
+
+CMakeSymbols::Id
+CMakeSymbols::Find(const wxString& name) const
+{
+    const wxScopedCharBuffer utf8 = name.utf8_str();
+
+    wxMutexLocker lock(m_mutex);
+    return m_slots[FindSlot(utf8.data(), utf8.length(), HashName(utf8.data(), utf8.length()))];
+}
+
+/* ************************************************************************ */
+
+CMakeSymbols::Id
+CMakeSymbols::FindFolded(const wxString& name) const
+{
+    return Find(name.Lower());
+}
+
+/* ************************************************************************ */
+
+CMakeSymbols::Id
+CMakeSymbols::Intern(const char* name, size_t length)
+{
+    const size_t hash = HashName(name, length);
+
+    wxMutexLocker lock(m_mutex);
+
+    const size_t slot = FindSlot(name, length, hash);
+
+    if (m_slots[slot] != InvalidId)
+        return m_slots[slot];
+
+    return Add(name, length);
+}
+
+/* ************************************************************************ */
+
+CMakeSymbols::Id
+CMakeSymbols::InternFolded(const char* name, size_t length)
+{
+    // Command names are short
+    char buffer[64];
+    std::string folded;
+
+    return Intern(FoldName(name, length, buffer, sizeof(buffer), folded), length);
+}
+
+/* ************************************************************************ */
+
+CMakeSymbols::Id
+CMakeSymbols::Intern(const wxString& name)
+{
+    const wxScopedCharBuffer utf8 = name.utf8_str();
+    return Intern(utf8.data(), utf8.length());
+}
+
+/* ************************************************************************ */
+
+size_t
+CMakeSymbols::FindSlot(const char* name, size_t length, size_t hash) const
+{
+    const size_t mask = m_slots.size() - 1;
+
+    // Linear probing
+    for (size_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+        const Id id = m_slots[slot];
+
+        if (id == InvalidId)
+            return slot;
+
+        const std::string& key = m_keys[id];
+
+        if (key.length() == length && !memcmp(key.data(), name, length))
+            return slot;
+    }
+}
+
+/* ************************************************************************ */
+
+CMakeSymbols::Id
+CMakeSymbols::Add(const char* name, size_t length)
+{
+    const Id id = static_cast<Id>(m_keys.size());
+
+    m_keys.push_back(std::string(name, length));
+    m_names.push_back(wxString::FromUTF8(name, length));
+
+    // Keep load factor under 1/2
+    if (m_keys.size() * 2 > m_slots.size()) {
+        m_slots.assign(m_slots.size() * 2, InvalidId);
+
+        for (Id i = 0; i < m_keys.size(); ++i) {
+            const std::string& key = m_keys[i];
+            m_slots[FindSlot(key.data(), key.length(), HashName(key.data(), key.length()))] = i;
+        }
+
+    } else {
+        m_slots[FindSlot(name, length, HashName(name, length))] = id;
+    }
+
+    return id;
+}
+
+/* ************************************************************************ */
+
+CMakeSymbolCache::CMakeSymbolCache()
+{
+    // Nothing to do
+}
+
+/* ************************************************************************ */
+
+void
+CMakeSymbolCache::Clear()
+{
+    std::vector<Entry>().swap(m_entries);
+    std::vector<size_t>().swap(m_slots);
+}
+
+/* ************************************************************************ */
+
+CMakeSymbols::Id
+CMakeSymbolCache::Intern(const char* name, size_t length)
+{
+    // Full cache is started again
+    if (m_entries.size() >= SYMBOL_CACHE_SIZE)
+        Clear();
+
+    if (m_slots.empty())
+        m_slots.assign(64, EMPTY_SLOT);
+
+    const size_t mask = m_slots.size() - 1;
+    size_t slot = HashName(name, length) & mask;
+
+    // Linear probing
+    for (; m_slots[slot] != EMPTY_SLOT; slot = (slot + 1) & mask) {
+        const Entry& entry = m_entries[m_slots[slot]];
+
+        if (entry.key.length() == length && !memcmp(entry.key.data(), name, length))
+            return entry.id;
+    }
+
+    // Only new names lock the global table
+    Entry entry;
+    entry.key.assign(name, length);
+    entry.id = CMakeSymbols::Get().Intern(name, length);
+
+    m_slots[slot] = m_entries.size();
+    m_entries.push_back(entry);
+
+    // Keep load factor under 1/2
+    if (m_entries.size() * 2 > m_slots.size()) {
+        m_slots.assign(m_slots.size() * 2, EMPTY_SLOT);
+        const size_t newMask = m_slots.size() - 1;
+
+        for (size_t i = 0; i < m_entries.size(); ++i) {
+            const std::string& key = m_entries[i].key;
+            size_t newSlot = HashName(key.data(), key.length()) & newMask;
+
+            while (m_slots[newSlot] != EMPTY_SLOT)
+                newSlot = (newSlot + 1) & newMask;
+
+            m_slots[newSlot] = i;
+        }
+    }
+
+    return entry.id;
+}
+
+/* ************************************************************************ */
+
+CMakeSymbols::Id
+CMakeSymbolCache::InternFolded(const char* name, size_t length)
+{
+    // Command names are short
+    char buffer[64];
+    std::string folded;
+
+    return Intern(FoldName(name, length, buffer, sizeof(buffer), folded), length);
+}
+
+/* ************************************************************************ */
@@ -0,0 +1,322 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+#ifndef CMAKE_SYMBOLS_H_
+#define CMAKE_SYMBOLS_H_
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// C++
+#include <deque>
+#include <string>
+#include <vector>
+
+// wxWidgets
+#include <wx/string.h>
+#include <wx/thread.h>
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Global table of interned names.
+ *
+ * Each distinct name gets a compact integer ID that is shared by all
+ * parsers, so names can be compared as integers and repeated names are
+ * stored only once. Command names are case-insensitive in CMake and they
+ * are interned in lower case (Fold methods), variable names are case
+ * sensitive and they're interned as they are.
+ *
+ * IDs are valid only during the process lifetime, so interned names are
+ * never removed. Table is thread-safe, parsers intern names through
+ * their own CMakeSymbolCache and lock the table only for new names.
+ */
+class CMakeSymbols
+{
+
+// Public Types
+public:
+
+
+    /// Symbol ID.
+    typedef unsigned int Id;
+
+
+// Public Enums
+public:
+
+
+    /**
+     * @brief Well-known command names, they have always these IDs.
+     */
+    enum WellKnown
+    {
+        Set = 0,
+        Option,
+        List,
+        Include,
+        AddSubdirectory,
+        FindPackage,
+
+        /// Number of well-known names.
+        WellKnownCount
+    };
+
+
+    /// Invalid ID.
+    static const Id InvalidId = static_cast<Id>(-1);
+
+
+// Public Ctors
+public:
+
+
+    /**
+     * @brief Returns the global table.
+     *
+     * @return
+     */
+    static CMakeSymbols& Get();
+
+
+// Public Accessors
+public:
+
+
+    /**
+     * @brief Returns name of the symbol.
+     *
+     * @param id Symbol ID.
+     *
+     * @return Reference is valid during the process lifetime.
+     */
+    const wxString& GetName(Id id) const;
+
+
+    /**
+     * @brief Finds case sensitive name.
+     *
+     * @param name Name.
+     *
+     * @return Symbol ID or InvalidId.
+     */
+    Id Find(const wxString& name) const;
+
+
+    /**
+     * @brief Finds case insensitive name (command name).
+     *
+     * @param name Name.
+     *
+     * @return Symbol ID or InvalidId.
+     */
+    Id FindFolded(const wxString& name) const;
+
+
+// Public Operations
+public:
+
+
+    /**
+     * @brief Interns case sensitive name (variable name).
+     *
+     * @param name   UTF-8 name.
+     * @param length Name length.
+     *
+     * @return Symbol ID.
+     */
+    Id Intern(const char* name, size_t length);
+
+
+    /**
+     * @brief Interns case insensitive name (command name).
+     *
+     * Only ASCII letters are folded.
+     *
+     * @param name   UTF-8 name.
+     * @param length Name length.
+     *
+     * @return Symbol ID of the lower case name.
+     */
+    Id InternFolded(const char* name, size_t length);
+
+
+    /**
+     * @brief Interns case sensitive name.
+     *
+     * @param name Name.
+     *
+     * @return Symbol ID.
+     */
+    Id Intern(const wxString& name);
+
+
+// Private Ctors
+private:
+
+
+    /**
+     * @brief Constructor.
+     */
+    CMakeSymbols();
+
+
+    /// Not copyable.
+    CMakeSymbols(const CMakeSymbols&);
+
+    /// Not copyable.
+    CMakeSymbols& operator=(const CMakeSymbols&);
+
+
+// Private Operations
+private:
+
+
+    /**
+     * @brief Finds symbol, must be called with locked mutex.
+     *
+     * @param name   UTF-8 name.
+     * @param length Name length.
+     * @param hash   Name hash.
+     *
+     * @return Slot index in the hash table.
+     */
+    size_t FindSlot(const char* name, size_t length, size_t hash) const;
+
+
+    /**
+     * @brief Adds symbol, must be called with locked mutex.
+     *
+     * @param name   UTF-8 name.
+     * @param length Name length.
+     *
+     * @return Symbol ID.
+     */
+    Id Add(const char* name, size_t length);
+
+
+// Private Data Members
+private:
+
+
+    /// UTF-8 names by ID (used for lookup).
+    std::deque<std::string> m_keys;
+
+    /// Names by ID (deque keeps references valid).
+    std::deque<wxString> m_names;
+
+    /// Open addressing hash table of IDs.
+    std::vector<Id> m_slots;
+
+    /// Guards everything.
+    mutable wxMutex m_mutex;
+
+};
+
+/* ************************************************************************ */
+
+/**
+ * @brief Local cache of symbols interned by one parser.
+ *
+ * Repeated names are found without locking the global table. Cache is
+ * not thread-safe, each parser has its own. Number of cached names is
+ * limited, the cache is cleared when it's full.
+ */
+class CMakeSymbolCache
+{
+
+// Public Ctors
+public:
+
+
+    /**
+     * @brief Constructor.
+     */
+    CMakeSymbolCache();
+
+
+// Public Operations
+public:
+
+
+    /**
+     * @brief Removes all cached names and frees memory.
+     */
+    void Clear();
+
+
+    /**
+     * @brief Interns case sensitive name (variable name).
+     *
+     * @param name   UTF-8 name.
+     * @param length Name length.
+     *
+     * @return Symbol ID.
+     */
+    CMakeSymbols::Id Intern(const char* name, size_t length);
+
+
+    /**
+     * @brief Interns case insensitive name (command name).
+     *
+     * @param name   UTF-8 name.
+     * @param length Name length.
+     *
+     * @return Symbol ID of the lower case name.
+     */
+    CMakeSymbols::Id InternFolded(const char* name, size_t length);
+
+
+// Private Structures
+private:
+
+
+    /**
+     * @brief Cached name.
+     */
+    struct Entry
+    {
+        /// UTF-8 name.
+        std::string key;
+
+        /// Symbol ID.
+        CMakeSymbols::Id id;
+    };
+
+
+// Private Data Members
+private:
+
+
+    /// Cached names.
+    std::vector<Entry> m_entries;
+
+    /// Open addressing hash table of entry indices.
+    std::vector<size_t> m_slots;
+
+};
+
+/* ************************************************************************ */
+
+#endif // CMAKE_SYMBOLS_H_
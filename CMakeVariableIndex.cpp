@@ -0,0 +1,233 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// Declaration
+#include "CMakeVariableIndex.h"
+
+// C++
+#include <algorithm>
+
+/* ************************************************************************ */
+/* STRUCTURES                                                               */
+/* ************************************************************************ */
+
+/**
+ * @brief Matches locations in given file.
+ */
+struct IsInFile
+{
+    /// File index.
+    size_t file;
+
+
+    /**
+     * @brief Constructor.
+     *
+     * @param file File index.
+     */
+    explicit IsInFile(size_t file)
+        : file(file)
+    {}
+
+
+    /**
+     * @brief Checks the location.
+     *
+     * @param location
+     *
+     * @return
+     */
+    bool operator()(const CMakeVariableIndex::Location& location) const {
+        return location.file == file;
+    }
+};
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Compares reference end with position (for binary search).
+ *
+ * @param reference Variable reference.
+ * @param pos       Position in the file.
+ *
+ * @return If reference ends before the position.
+ */
+static bool IsReferenceBefore(const CMakeParser::Reference& reference, size_t pos)
+{
+    return reference.pos + reference.length < pos;
+}
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+CMakeVariableIndex::CMakeVariableIndex()
+{
+    // Nothing to do
+}
+
+/* ************************************************************************ */
+
+const wxVector<CMakeVariableIndex::Location>&
+CMakeVariableIndex::GetDefinitions(CMakeSymbols::Id name) const
+{
+    static const wxVector<Location> s_empty;
+
+    if (name >= m_entries.size())
+        return s_empty;
+
+    return m_entries[name].definitions;
+}
+
+/* ************************************************************************ */
+
+const wxVector<CMakeVariableIndex::Location>&
+CMakeVariableIndex::GetUses(CMakeSymbols::Id name) const
+{
+    static const wxVector<Location> s_empty;
+
+    if (name >= m_entries.size())
+        return s_empty;
+
+    return m_entries[name].uses;
+}
+
+/* ************************************************************************ */
+
+CMakeSymbols::Id
+CMakeVariableIndex::Find(const wxString& path, size_t pos) const
+{
+    std::map<wxString, size_t>::const_iterator it = m_paths.find(path);
+
+    if (it == m_paths.end())
+        return CMakeSymbols::InvalidId;
+
+    const wxVector<CMakeParser::Reference>& references = m_files[it->second].references;
+
+    // The first reference which doesn't end before the position, caret
+    // just after the name still belongs to it
+    wxVector<CMakeParser::Reference>::const_iterator ref = std::lower_bound(
+        references.begin(), references.end(), pos, IsReferenceBefore);
+
+    if (ref == references.end() || ref->pos > pos)
+        return CMakeSymbols::InvalidId;
+
+    return ref->name;
+}
+
+/* ************************************************************************ */
+
+void
+CMakeVariableIndex::Clear()
+{
+    m_files.clear();
+    m_paths.clear();
+    m_entries.clear();
+}
+
+/* ************************************************************************ */
+
+void
+CMakeVariableIndex::Update(const CMakeParser& parser)
+{
+    const wxString path = parser.GetFilename().GetFullPath();
+
+    std::map<wxString, size_t>::iterator it = m_paths.find(path);
+    size_t file;
+
+    if (it == m_paths.end()) {
+        file = m_files.size();
+        m_files.push_back(File());
+        m_files.back().path = path;
+        m_paths[path] = file;
+    } else {
+        file = it->second;
+        RemoveLocations(file);
+    }
+
+    const wxVector<CMakeParser::Reference>& references = parser.GetReferences();
+    m_files[file].references = references;
+
+    for (wxVector<CMakeParser::Reference>::const_iterator ref = references.begin(),
+        refe = references.end(); ref != refe; ++ref) {
+        if (ref->name >= m_entries.size())
+            m_entries.resize(ref->name + 1);
+
+        Entry& entry = m_entries[ref->name];
+        const Location location = {file, ref->pos, ref->length};
+
+        if (ref->definition)
+            entry.definitions.push_back(location);
+        else
+            entry.uses.push_back(location);
+    }
+}
+
+/* ************************************************************************ */
+
+void
+CMakeVariableIndex::Remove(const wxString& path)
+{
+    std::map<wxString, size_t>::iterator it = m_paths.find(path);
+
+    if (it == m_paths.end())
+        return;
+
+    RemoveLocations(it->second);
+    m_files[it->second].references.clear();
+    m_paths.erase(it);
+}
+
+/* ************************************************************************ */
+
+void
+CMakeVariableIndex::RemoveLocations(size_t file)
+{
+    // Variables referenced by the file
+    wxVector<CMakeSymbols::Id> names;
+    const wxVector<CMakeParser::Reference>& references = m_files[file].references;
+
+    for (wxVector<CMakeParser::Reference>::const_iterator ref = references.begin(),
+        refe = references.end(); ref != refe; ++ref) {
+        names.push_back(ref->name);
+    }
+
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+
+    for (wxVector<CMakeSymbols::Id>::const_iterator name = names.begin(),
+        namee = names.end(); name != namee; ++name) {
+        Entry& entry = m_entries[*name];
+
+        entry.definitions.erase(std::remove_if(entry.definitions.begin(),
+            entry.definitions.end(), IsInFile(file)), entry.definitions.end());
+        entry.uses.erase(std::remove_if(entry.uses.begin(),
+            entry.uses.end(), IsInFile(file)), entry.uses.end());
+    }
+}
+
+/* ************************************************************************ */
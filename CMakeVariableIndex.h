@@ -0,0 +1,242 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+#ifndef CMAKE_VARIABLE_INDEX_H_
+#define CMAKE_VARIABLE_INDEX_H_
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// C++
+#include <map>
+
+// wxWidgets
+#include <wx/string.h>
+#include <wx/vector.h>
+
+// CMakePlugin
+#include "CMakeParser.h"
+#include "CMakeSymbols.h"
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Index of variable definitions and uses across CMake files.
+ *
+ * Index is built from variable references of parsed files and it's
+ * updated per file, so a saved file replaces only its own locations.
+ * Locations of a variable are found directly by its symbol ID and
+ * the variable at a position by binary search in the file references.
+ *
+ * Index keeps only positions, it doesn't need the parsed files. It's
+ * not thread-safe.
+ */
+class CMakeVariableIndex
+{
+
+// Public Structures
+public:
+
+
+    /**
+     * @brief Location of a variable reference.
+     */
+    struct Location
+    {
+        /// File index.
+        size_t file;
+
+        /// Variable name position (in bytes).
+        size_t pos;
+
+        /// Variable name length (in bytes).
+        size_t length;
+    };
+
+
+// Public Ctors
+public:
+
+
+    /**
+     * @brief Constructor.
+     */
+    CMakeVariableIndex();
+
+
+// Public Accessors
+public:
+
+
+    /**
+     * @brief Returns number of indexed files.
+     *
+     * @return
+     */
+    size_t GetFileCount() const {
+        return m_paths.size();
+    }
+
+
+    /**
+     * @brief Checks if file is indexed.
+     *
+     * @param path Full path to the file.
+     *
+     * @return
+     */
+    bool HasFile(const wxString& path) const {
+        return m_paths.find(path) != m_paths.end();
+    }
+
+
+    /**
+     * @brief Returns path of indexed file.
+     *
+     * @param file File index (from Location).
+     *
+     * @return
+     */
+    const wxString& GetPath(size_t file) const {
+        return m_files[file].path;
+    }
+
+
+    /**
+     * @brief Returns definitions of the variable.
+     *
+     * @param name Variable symbol.
+     *
+     * @return Locations grouped by file and ordered by position.
+     */
+    const wxVector<Location>& GetDefinitions(CMakeSymbols::Id name) const;
+
+
+    /**
+     * @brief Returns uses of the variable.
+     *
+     * @param name Variable symbol.
+     *
+     * @return Locations grouped by file and ordered by position.
+     */
+    const wxVector<Location>& GetUses(CMakeSymbols::Id name) const;
+
+
+    /**
+     * @brief Finds variable referenced at the position.
+     *
+     * @param path Path to the file.
+     * @param pos  Position in the file (in bytes).
+     *
+     * @return Variable symbol or CMakeSymbols::InvalidId.
+     */
+    CMakeSymbols::Id Find(const wxString& path, size_t pos) const;
+
+
+// Public Operations
+public:
+
+
+    /**
+     * @brief Removes everything from the index.
+     */
+    void Clear();
+
+
+    /**
+     * @brief Replaces locations of the parser's file by its references.
+     *
+     * @param parser Parser of the file.
+     */
+    void Update(const CMakeParser& parser);
+
+
+    /**
+     * @brief Removes locations of the file.
+     *
+     * @param path Path to the file.
+     */
+    void Remove(const wxString& path);
+
+
+// Private Structures
+private:
+
+
+    /**
+     * @brief Indexed file.
+     */
+    struct File
+    {
+        /// Full path.
+        wxString path;
+
+        /// References ordered by position.
+        wxVector<CMakeParser::Reference> references;
+    };
+
+
+    /**
+     * @brief Locations of one variable.
+     */
+    struct Entry
+    {
+        /// Definitions.
+        wxVector<Location> definitions;
+
+        /// Uses.
+        wxVector<Location> uses;
+    };
+
+
+// Private Operations
+private:
+
+
+    /**
+     * @brief Removes locations of the file from the variable entries.
+     *
+     * @param file File index.
+     */
+    void RemoveLocations(size_t file);
+
+
+// Private Data Members
+private:
+
+
+    /// Indexed files (indices are never reused).
+    wxVector<File> m_files;
+
+    /// Map of file path to file index.
+    std::map<wxString, size_t> m_paths;
+
+    /// Variable entries by symbol ID.
+    wxVector<Entry> m_entries;
+
+};
+
+/* ************************************************************************ */
+
+#endif // CMAKE_VARIABLE_INDEX_H_
@@ -27,6 +27,7 @@
 
 // wxWidgets
 #include <wx/app.h>
+#include <wx/msgdlg.h>
 
 // CMakePlugin
 #include "CMakeGenerator.h"
@@ -46,10 +47,12 @@ CMakeWorkspaceMenu::CMakeWorkspaceMenu(CMakePlugin* plugin)
 
     // Export
     Append(new wxMenuItem(this, ID_EXPORT_CMAKELISTS, _("Export CMakeLists.txt")));
+    Append(new wxMenuItem(this, ID_EXPORT_ALL_CMAKELISTS, _("Export All CMakeLists.txt")));
 
     // Bind events
     wxTheApp->Bind(wxEVT_MENU, &CMakeWorkspaceMenu::OnCMakeListsOpen, this, ID_OPEN_CMAKELISTS);
     wxTheApp->Bind(wxEVT_MENU, &CMakeWorkspaceMenu::OnExport, this, ID_EXPORT_CMAKELISTS);
+    wxTheApp->Bind(wxEVT_MENU, &CMakeWorkspaceMenu::OnExportAll, this, ID_EXPORT_ALL_CMAKELISTS);
 
     wxTheApp->Bind(wxEVT_UPDATE_UI, &CMakeWorkspaceMenu::OnFileExists, this, ID_OPEN_CMAKELISTS);
 }
@@ -58,8 +61,9 @@ CMakeWorkspaceMenu::CMakeWorkspaceMenu(CMakePlugin* plugin)
 
 CMakeWorkspaceMenu::~CMakeWorkspaceMenu()
 {
-    wxTheApp->Bind(wxEVT_MENU, &CMakeWorkspaceMenu::OnCMakeListsOpen, this, ID_OPEN_CMAKELISTS);
-    wxTheApp->Bind(wxEVT_MENU, &CMakeWorkspaceMenu::OnExport, this, ID_EXPORT_CMAKELISTS);
+    wxTheApp->Unbind(wxEVT_MENU, &CMakeWorkspaceMenu::OnCMakeListsOpen, this, ID_OPEN_CMAKELISTS);
+    wxTheApp->Unbind(wxEVT_MENU, &CMakeWorkspaceMenu::OnExport, this, ID_EXPORT_CMAKELISTS);
+    wxTheApp->Unbind(wxEVT_MENU, &CMakeWorkspaceMenu::OnExportAll, this, ID_EXPORT_ALL_CMAKELISTS);
 
     wxTheApp->Unbind(wxEVT_UPDATE_UI, &CMakeWorkspaceMenu::OnFileExists, this, ID_OPEN_CMAKELISTS);
 }
@@ -69,7 +73,23 @@ CMakeWorkspaceMenu::~CMakeWorkspaceMenu()
 void
 CMakeWorkspaceMenu::OnExport(wxCommandEvent& event)
 {
-    CMakeGenerator::Generate(m_plugin->GetManager()->GetWorkspace());
+    CMakeGenerator::Generate(m_plugin->GetManager()->GetWorkspace(),
+                             m_plugin->GetDirectorySnapshot());
+}
+
+/* ************************************************************************ */
+
+void
+CMakeWorkspaceMenu::OnExportAll(wxCommandEvent& event)
+{
+    wxUnusedVar(event);
+
+    const size_t changed = CMakeGenerator::GenerateAll(m_plugin->GetManager()->GetWorkspace(),
+                                                       m_plugin->GetDirectorySnapshot());
+
+    wxMessageBox(wxString::Format(wxPLURAL("%u %s file changed.", "%u %s files changed.", changed),
+        static_cast<unsigned int>(changed), CMakePlugin::CMAKELISTS_FILE),
+        wxMessageBoxCaptionStr, wxOK | wxCENTER | wxICON_INFORMATION);
 }
 
 /* ************************************************************************ */
@@ -47,7 +47,8 @@ public:
     enum IDs
     {
         ID_OPEN_CMAKELISTS = 2456,
-        ID_EXPORT_CMAKELISTS
+        ID_EXPORT_CMAKELISTS,
+        ID_EXPORT_ALL_CMAKELISTS
     };
 
 // Public Ctors & Dtors
@@ -101,6 +102,14 @@ public:
     void OnExport(wxCommandEvent& event);
 
 
+    /**
+     * @brief On export of CMakeLists.txt for all projects request.
+     *
+     * @param event
+     */
+    void OnExportAll(wxCommandEvent& event);
+
+
 
 // Private Data Members
 private:
@@ -0,0 +1,407 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// C++
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+// wxWidgets
+#include <wx/init.h>
+#include <wx/string.h>
+#include <wx/stopwatch.h>
+
+// CMakePlugin
+#include "../CMake.h"
+#include "../CMakeHelpIndex.h"
+#include "../CMakeHelpFuzzy.h"
+
+/* ************************************************************************ */
+/* VARIABLES                                                                */
+/* ************************************************************************ */
+
+/// Per-keystroke latency budget in microseconds.
+static const wxLongLong_t BUDGET = 1000;
+
+/// Real command names.
+static const char* const COMMANDS[] = {
+    "add_compile_definitions", "add_compile_options", "add_custom_command",
+    "add_custom_target", "add_definitions", "add_dependencies",
+    "add_executable", "add_library", "add_link_options", "add_subdirectory",
+    "add_test", "aux_source_directory", "break", "build_command",
+    "cmake_host_system_information", "cmake_language", "cmake_minimum_required",
+    "cmake_parse_arguments", "cmake_path", "cmake_policy", "configure_file",
+    "continue", "create_test_sourcelist", "ctest_build", "ctest_configure",
+    "ctest_coverage", "ctest_empty_binary_directory", "ctest_memcheck",
+    "ctest_read_custom_files", "ctest_run_script", "ctest_sleep", "ctest_start",
+    "ctest_submit", "ctest_test", "ctest_update", "ctest_upload",
+    "define_property", "else", "elseif", "enable_language", "enable_testing",
+    "endforeach", "endfunction", "endif", "endmacro", "endwhile",
+    "execute_process", "export", "file", "find_file", "find_library",
+    "find_package", "find_path", "find_program", "fltk_wrap_ui", "foreach",
+    "function", "get_cmake_property", "get_directory_property",
+    "get_filename_component", "get_property", "get_source_file_property",
+    "get_target_property", "get_test_property", "if", "include",
+    "include_directories", "include_external_msproject",
+    "include_guard", "include_regular_expression", "install", "link_directories",
+    "link_libraries", "list", "load_cache", "macro", "mark_as_advanced",
+    "math", "message", "option", "project", "qt_wrap_cpp", "qt_wrap_ui",
+    "remove_definitions", "return", "separate_arguments", "set",
+    "set_directory_properties", "set_property", "set_source_files_properties",
+    "set_target_properties", "set_tests_properties", "site_name",
+    "source_group", "string", "target_compile_definitions",
+    "target_compile_features", "target_compile_options", "target_include_directories",
+    "target_link_directories", "target_link_libraries", "target_link_options",
+    "target_precompile_headers", "target_sources", "try_compile", "try_run",
+    "unset", "variable_watch", "while"
+};
+
+/// Languages used in templated names.
+static const char* const LANGUAGES[] = {
+    "C", "CXX", "CUDA", "Fortran", "ASM", "OBJC", "OBJCXX", "Swift", "HIP", "ISPC"
+};
+
+/// Configurations used in templated names.
+static const char* const CONFIGS[] = {
+    "DEBUG", "RELEASE", "RELWITHDEBINFO", "MINSIZEREL"
+};
+
+/// Suffixes of CMAKE_<LANG>_* variables.
+static const char* const LANGUAGE_VARIABLES[] = {
+    "ANDROID_TOOLCHAIN_PREFIX", "ARCHIVE_APPEND", "ARCHIVE_CREATE", "ARCHIVE_FINISH",
+    "BYTE_ORDER", "CLANG_TIDY", "COMPILER", "COMPILER_ABI", "COMPILER_AR",
+    "COMPILER_ARCHITECTURE_ID", "COMPILER_EXTERNAL_TOOLCHAIN", "COMPILER_FRONTEND_VARIANT",
+    "COMPILER_ID", "COMPILER_LAUNCHER", "COMPILER_LOADED", "COMPILER_PREDEFINES_COMMAND",
+    "COMPILER_RANLIB", "COMPILER_TARGET", "COMPILER_VERSION", "COMPILE_OBJECT",
+    "CPPCHECK", "CPPLINT", "CREATE_SHARED_LIBRARY", "CREATE_SHARED_MODULE",
+    "CREATE_STATIC_LIBRARY", "EXTENSIONS", "FLAGS", "FLAGS_INIT",
+    "IGNORE_EXTENSIONS", "IMPLICIT_INCLUDE_DIRECTORIES", "IMPLICIT_LINK_DIRECTORIES",
+    "IMPLICIT_LINK_LIBRARIES", "INCLUDE_WHAT_YOU_USE", "LIBRARY_ARCHITECTURE",
+    "LINKER_LAUNCHER", "LINKER_PREFERENCE", "LINK_EXECUTABLE", "LINK_LIBRARY_FILE_FLAG",
+    "LINK_LIBRARY_FLAG", "LINK_WHAT_YOU_USE_FLAG", "OUTPUT_EXTENSION",
+    "PLATFORM_ID", "SIMULATE_ID", "SIMULATE_VERSION", "SIZEOF_DATA_PTR",
+    "SOURCE_FILE_EXTENSIONS", "STANDARD", "STANDARD_INCLUDE_DIRECTORIES",
+    "STANDARD_LIBRARIES", "STANDARD_REQUIRED", "VISIBILITY_PRESET"
+};
+
+/// Suffixes of CMAKE_<LANG>_*_<CONFIG> variables.
+static const char* const CONFIG_VARIABLES[] = {
+    "FLAGS", "FLAGS_INIT", "POSTFIX", "LINKER_FLAGS"
+};
+
+/// Words used to compose other names.
+static const char* const WORDS[] = {
+    "INSTALL", "PREFIX", "BINARY", "SOURCE", "DIR", "CURRENT", "PROJECT",
+    "OUTPUT", "DIRECTORY", "RUNTIME", "LIBRARY", "ARCHIVE", "LINK", "INTERFACE",
+    "IMPORTED", "LOCATION", "COMPILE", "OPTIONS", "DEFINITIONS", "FEATURES",
+    "VERSION", "SYSTEM", "NAME", "PROCESSOR", "FIND", "ROOT", "PATH", "MODE",
+    "PACKAGE", "EXPORT", "GENERATOR", "PLATFORM", "TOOLSET", "POLICY", "DEFAULT",
+    "TEST", "TIMEOUT", "DEPENDS", "PROPERTIES", "AUTOMOC", "AUTOUIC", "AUTORCC"
+};
+
+/// Typed queries, each prefix is one keystroke.
+static const char* const QUERIES[] = {
+    "add_executable", "target_link_libraries", "CMAKE_CXX_FLAGS_RELEASE",
+    "CMAKE_INSTALL_PREFIX", "find_package", "ctest_submit", "CPACK_GENERATOR",
+    "IMPORTED_LOCATION", "INTERFACE_INCLUDE_DIRECTORIES", "tll", "cxxflags",
+    "cmcxxfl", "instpref", "imploc", "findpkg", "e", "z"
+};
+
+/* ************************************************************************ */
+/* STRUCTURES                                                               */
+/* ************************************************************************ */
+
+/**
+ * @brief Latency statistics of keystrokes.
+ */
+struct Stats
+{
+    /// Number of keystrokes.
+    size_t keystrokes;
+
+    /// Mean latency in microseconds.
+    double mean;
+
+    /// 99th percentile latency in microseconds.
+    wxLongLong_t p99;
+
+    /// Maximum latency in microseconds.
+    wxLongLong_t max;
+
+    /// Average number of results.
+    double results;
+};
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Adds name into help list.
+ *
+ * @param list Help list.
+ * @param name Item name.
+ */
+static void AddName(CMake::HelpMap& list, const wxString& name)
+{
+    list[name] = wxString();
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Generates names similar to CMake help lists.
+ *
+ * With scale 1 the lists are about the size of CMake 3.x lists
+ * (~100 commands, ~350 modules, ~700 properties, ~1100 variables).
+ *
+ * @param scale Multiplier of generated names.
+ * @param lists Output help lists (commands, modules, properties, variables).
+ */
+static void GenerateNames(size_t scale, CMake::HelpMap lists[4])
+{
+    const size_t words = sizeof(WORDS) / sizeof(WORDS[0]);
+    const size_t languages = sizeof(LANGUAGES) / sizeof(LANGUAGES[0]);
+    const size_t configs = sizeof(CONFIGS) / sizeof(CONFIGS[0]);
+
+    for (size_t s = 0; s < scale; ++s) {
+        // Suffix makes names of next scales unique
+        const wxString suffix = s ? wxString::Format("_%u", static_cast<unsigned>(s)) : wxString();
+
+        // Commands
+        for (size_t i = 0; i < sizeof(COMMANDS) / sizeof(COMMANDS[0]); ++i)
+            AddName(lists[0], wxString(COMMANDS[i]) + suffix.Lower());
+
+        // Modules
+        for (size_t i = 0; i < words; ++i) {
+            for (size_t j = 0; j < 8; ++j) {
+                wxString name = wxString(WORDS[i]).Left(1) + wxString(WORDS[i]).Mid(1).Lower();
+                name += wxString(WORDS[(i + j * 7 + 1) % words]).Left(1) + wxString(WORDS[(i + j * 7 + 1) % words]).Mid(1).Lower();
+                AddName(lists[1], (j % 2 ? "Find" : "Check") + name + suffix);
+            }
+        }
+
+        // Properties
+        for (size_t i = 0; i < words; ++i) {
+            for (size_t j = 0; j < words; j += 3)
+                AddName(lists[2], wxString(WORDS[i]) + "_" + WORDS[j] + suffix);
+        }
+
+        for (size_t i = 0; i < configs; ++i) {
+            for (size_t j = 0; j < words; j += 2)
+                AddName(lists[2], wxString(WORDS[j]) + "_" + CONFIGS[i] + suffix);
+        }
+
+        // Variables
+        for (size_t i = 0; i < languages; ++i) {
+            for (size_t j = 0; j < sizeof(LANGUAGE_VARIABLES) / sizeof(LANGUAGE_VARIABLES[0]); ++j)
+                AddName(lists[3], wxString("CMAKE_") + LANGUAGES[i] + "_" + LANGUAGE_VARIABLES[j] + suffix);
+
+            for (size_t j = 0; j < configs; ++j) {
+                for (size_t k = 0; k < sizeof(CONFIG_VARIABLES) / sizeof(CONFIG_VARIABLES[0]); ++k)
+                    AddName(lists[3], wxString("CMAKE_") + LANGUAGES[i] + "_" + CONFIG_VARIABLES[k] + "_" + CONFIGS[j] + suffix);
+            }
+        }
+
+        for (size_t i = 0; i < words; ++i) {
+            for (size_t j = 0; j < words; j += 4) {
+                AddName(lists[3], wxString("CMAKE_") + WORDS[i] + "_" + WORDS[j] + suffix);
+                AddName(lists[3], wxString(j % 8 ? "CPACK_" : "CTEST_") + WORDS[j] + "_" + WORDS[i] + suffix);
+            }
+        }
+    }
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Types all queries character by character.
+ *
+ * Each keystroke is repeated and the fastest run is taken, so the
+ * result is not affected by scheduler noise.
+ *
+ * @param fuzzy   Matcher.
+ * @param repeats Number of runs of each keystroke.
+ *
+ * @return
+ */
+static Stats BenchQueries(const CMakeHelpFuzzy& fuzzy, size_t repeats)
+{
+    std::vector<wxLongLong_t> times;
+    size_t results = 0;
+    CMakeHelpIndex::Items items;
+
+    for (size_t i = 0; i < sizeof(QUERIES) / sizeof(QUERIES[0]); ++i) {
+        const wxString query = QUERIES[i];
+
+        for (size_t length = 1; length <= query.length(); ++length) {
+            const wxString typed = query.Left(length);
+            wxLongLong_t best = -1;
+
+            for (size_t r = 0; r < repeats; ++r) {
+                wxStopWatch watch;
+                fuzzy.Match(typed, items);
+                const wxLongLong_t time = watch.TimeInMicro().GetValue();
+
+                if (best < 0 || time < best)
+                    best = time;
+            }
+
+            times.push_back(best);
+            results += items.size();
+        }
+    }
+
+    std::sort(times.begin(), times.end());
+
+    Stats stats = {times.size(), 0.0, 0, 0, 0.0};
+
+    for (size_t i = 0; i < times.size(); ++i)
+        stats.mean += static_cast<double>(times[i]);
+
+    stats.mean /= times.size();
+    stats.p99 = times[(times.size() * 99) / 100];
+    stats.max = times.back();
+    stats.results = static_cast<double>(results) / times.size();
+
+    return stats;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Prints usage.
+ *
+ * @param program Program name.
+ */
+static void PrintUsage(const char* program)
+{
+    printf(
+        "Usage: %s [-n repeats] [-s scale]\n"
+        "\n"
+        "Types help search queries character by character into the fuzzy\n"
+        "matcher built from generated names of all help topics and reports\n"
+        "per-keystroke latency. Scale multiplies the number of names.\n"
+        "Exit code is 2 if any keystroke exceeds the 1 ms budget.\n",
+        program
+    );
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Entry point.
+ *
+ * @param argc
+ * @param argv
+ *
+ * @return Exit code.
+ */
+int main(int argc, char** argv)
+{
+    wxInitializer initializer;
+
+    if (!initializer.IsOk()) {
+        fprintf(stderr, "Unable to initialize wxWidgets\n");
+        return 1;
+    }
+
+    size_t repeats = 20;
+    std::vector<size_t> scales;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            repeats = strtoul(argv[++i], NULL, 10);
+        } else if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+            scales.push_back(strtoul(argv[++i], NULL, 10));
+        } else {
+            PrintUsage(argv[0]);
+            return !strcmp(argv[i], "-h") || !strcmp(argv[i], "--help") ? 0 : 1;
+        }
+    }
+
+    if (!repeats) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    // Real size and ten times more
+    if (scales.empty()) {
+        scales.push_back(1);
+        scales.push_back(10);
+    }
+
+    printf("matcher: %s\n", CMakeHelpFuzzy::GetKernelName());
+    printf("%-6s %8s %10s %10s %10s %10s %10s %8s\n",
+        "scale", "names", "keystrokes", "build ms", "mean us", "p99 us", "max us", "results");
+
+    bool ok = true;
+
+    for (size_t i = 0; i < scales.size(); ++i) {
+        if (!scales[i])
+            continue;
+
+        CMake::HelpMap lists[4];
+        GenerateNames(scales[i], lists);
+
+        CMakeHelpIndex indices[4];
+        size_t names = 0;
+
+        for (int j = 0; j < 4; ++j) {
+            indices[j].Build(lists[j]);
+            names += indices[j].GetCount();
+        }
+
+        wxStopWatch watch;
+        CMakeHelpFuzzy fuzzy;
+        fuzzy.Build(indices, 4);
+        const long build = watch.Time();
+
+        const Stats stats = BenchQueries(fuzzy, repeats);
+
+        printf("%-6u %8u %10u %10ld %10.1f %10ld %10ld %8.0f\n",
+            static_cast<unsigned>(scales[i]),
+            static_cast<unsigned>(names),
+            static_cast<unsigned>(stats.keystrokes),
+            build,
+            stats.mean,
+            static_cast<long>(stats.p99),
+            static_cast<long>(stats.max),
+            stats.results
+        );
+
+        // Budget applies to the real size
+        if (scales[i] == 1 && stats.max >= BUDGET)
+            ok = false;
+    }
+
+    printf("budget %ld us per keystroke: %s\n", static_cast<long>(BUDGET), ok ? "OK" : "EXCEEDED");
+
+    return ok ? 0 : 2;
+}
+
+/* ************************************************************************ */
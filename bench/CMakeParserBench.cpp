@@ -0,0 +1,463 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// C++
+#include <new>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// POSIX
+#ifndef __WXMSW__
+#include <sys/resource.h>
+#endif
+
+// wxWidgets
+#include <wx/init.h>
+#include <wx/string.h>
+#include <wx/arrstr.h>
+#include <wx/filename.h>
+#include <wx/dir.h>
+#include <wx/stopwatch.h>
+
+// CMakePlugin
+#include "../CMakeParser.h"
+
+/* ************************************************************************ */
+/* VARIABLES                                                                */
+/* ************************************************************************ */
+
+/// Number of allocations made by operator new.
+static size_t g_allocations = 0;
+
+/// Number of bytes allocated by operator new.
+static size_t g_allocatedBytes = 0;
+
+/* ************************************************************************ */
+/* STRUCTURES                                                               */
+/* ************************************************************************ */
+
+/**
+ * @brief Result of one benchmark.
+ */
+struct Result
+{
+    /// Parsed bytes per iteration.
+    size_t bytes;
+
+    /// Parsed commands per iteration.
+    size_t commands;
+
+    /// Total time in microseconds.
+    wxLongLong_t time;
+
+    /// Allocations per iteration.
+    size_t allocations;
+
+    /// Allocated bytes per iteration.
+    size_t allocatedBytes;
+};
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Counts allocations, the benchmark is single threaded.
+ */
+void* operator new(size_t size)
+{
+    ++g_allocations;
+    g_allocatedBytes += size;
+
+    void* ptr = malloc(size ? size : 1);
+
+    if (!ptr)
+        throw std::bad_alloc();
+
+    return ptr;
+}
+
+/* ************************************************************************ */
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+/* ************************************************************************ */
+
+void operator delete(void* ptr)
+{
+    free(ptr);
+}
+
+/* ************************************************************************ */
+
+void operator delete[](void* ptr)
+{
+    free(ptr);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Returns peak resident set size of the process.
+ *
+ * @return Size in kB or 0 if it's not known.
+ */
+static size_t GetPeakRss()
+{
+#ifndef __WXMSW__
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage))
+        return 0;
+
+#ifdef __WXMAC__
+    // Bytes on OS X
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Generates ordinary commands with quoted arguments and variable
+ * references.
+ *
+ * @param count Number of commands.
+ *
+ * @return UTF-8 source.
+ */
+static std::string GenerateCommands(size_t count)
+{
+    std::string source;
+    char line[256];
+
+    for (size_t i = 0; i < count; ++i) {
+        sprintf(line,
+            "if(DEFINED VAR_%u)\n"
+            "    set(VAR_%u \"value ${VAR_%u}\" ${CMAKE_CURRENT_SOURCE_DIR}/file_%u.cpp)\n"
+            "endif()\n",
+            static_cast<unsigned>(i), static_cast<unsigned>(i),
+            static_cast<unsigned>(i / 2), static_cast<unsigned>(i));
+        source += line;
+    }
+
+    return source;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Generates commands with deeply nested parentheses.
+ *
+ * @param count Number of commands.
+ * @param depth Nesting depth.
+ *
+ * @return UTF-8 source.
+ */
+static std::string GenerateNesting(size_t count, size_t depth)
+{
+    std::string source;
+
+    for (size_t i = 0; i < count; ++i) {
+        source += "if(";
+
+        for (size_t j = 0; j < depth; ++j) {
+            source += "(A AND ";
+        }
+
+        source += "B";
+        source.append(depth, ')');
+        source += ")\nendif()\n";
+    }
+
+    return source;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Generates commands with very long argument lists.
+ *
+ * @param count     Number of commands.
+ * @param arguments Number of arguments of each command.
+ *
+ * @return UTF-8 source.
+ */
+static std::string GenerateArguments(size_t count, size_t arguments)
+{
+    std::string source;
+    char argument[64];
+
+    for (size_t i = 0; i < count; ++i) {
+        source += "list(APPEND SOURCES\n";
+
+        for (size_t j = 0; j < arguments; ++j) {
+            sprintf(argument, "    src/module_%u/file_%u.cpp\n",
+                static_cast<unsigned>(i), static_cast<unsigned>(j));
+            source += argument;
+        }
+
+        source += ")\n";
+    }
+
+    return source;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Generates huge line and bracket comment blocks.
+ *
+ * @param count Number of blocks.
+ * @param lines Lines of each block.
+ *
+ * @return UTF-8 source.
+ */
+static std::string GenerateComments(size_t count, size_t lines)
+{
+    std::string source;
+    const std::string text = "Lorem ipsum dolor sit amet, set(NOT_A_COMMAND) ${NOT_A_VARIABLE}\n";
+
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < lines; ++j) {
+            source += "# ";
+            source += text;
+        }
+
+        source += "#[==[\n";
+
+        for (size_t j = 0; j < lines; ++j) {
+            source += text;
+        }
+
+        source += "]==]\nmessage(STATUS \"block\")\n";
+    }
+
+    return source;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Parses the source repeatedly.
+ *
+ * The first parse is not measured, it fills the symbol table.
+ *
+ * @param source     UTF-8 source.
+ * @param iterations Number of measured iterations.
+ *
+ * @return
+ */
+static Result BenchSource(const std::string& source, size_t iterations)
+{
+    const wxString content = wxString::FromUTF8(source.data(), source.size());
+    CMakeParser parser;
+    parser.Parse(content);
+
+    Result result = {source.size(), parser.GetCommands().size(), 0, 0, 0};
+
+    const size_t allocations = g_allocations;
+    const size_t allocatedBytes = g_allocatedBytes;
+
+    wxStopWatch watch;
+
+    for (size_t i = 0; i < iterations; ++i) {
+        parser.Parse(content);
+    }
+
+    result.time = watch.TimeInMicro().GetValue();
+    result.allocations = (g_allocations - allocations) / iterations;
+    result.allocatedBytes = (g_allocatedBytes - allocatedBytes) / iterations;
+
+    return result;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Parses the files repeatedly.
+ *
+ * The first parse is not measured, it fills the symbol table and
+ * the system file cache.
+ *
+ * @param files      Paths to files.
+ * @param iterations Number of measured iterations.
+ *
+ * @return
+ */
+static Result BenchFiles(const wxArrayString& files, size_t iterations)
+{
+    CMakeParser parser;
+    Result result = {0, 0, 0, 0, 0};
+
+    for (size_t i = 0; i < files.GetCount(); ++i) {
+        if (!parser.ParseFile(wxFileName(files[i])))
+            continue;
+
+        result.bytes += parser.GetSize();
+        result.commands += parser.GetCommands().size();
+    }
+
+    const size_t allocations = g_allocations;
+    const size_t allocatedBytes = g_allocatedBytes;
+
+    wxStopWatch watch;
+
+    for (size_t i = 0; i < iterations; ++i) {
+        for (size_t j = 0; j < files.GetCount(); ++j) {
+            parser.ParseFile(wxFileName(files[j]));
+        }
+    }
+
+    result.time = watch.TimeInMicro().GetValue();
+    result.allocations = (g_allocations - allocations) / iterations;
+    result.allocatedBytes = (g_allocatedBytes - allocatedBytes) / iterations;
+
+    return result;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Prints benchmark result.
+ *
+ * @param name       Benchmark name.
+ * @param result     Result.
+ * @param iterations Number of iterations.
+ */
+static void PrintResult(const char* name, const Result& result, size_t iterations)
+{
+    // Avoid division by zero
+    const double seconds = (result.time ? result.time : 1) / 1e6;
+    const double bytes = static_cast<double>(result.bytes) * iterations;
+    const double commands = static_cast<double>(result.commands) * iterations;
+
+    printf("%-12s %10.2f %10u %10.1f %10.1f %12.0f %12u %12u\n",
+        name,
+        result.bytes / (1024.0 * 1024.0),
+        static_cast<unsigned>(result.commands),
+        seconds * 1e3 / iterations,
+        bytes / (1024.0 * 1024.0) / seconds,
+        commands / seconds,
+        static_cast<unsigned>(result.allocations),
+        static_cast<unsigned>(result.allocatedBytes / 1024)
+    );
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Prints usage.
+ *
+ * @param program Program name.
+ */
+static void PrintUsage(const char* program)
+{
+    printf(
+        "Usage: %s [-n iterations] [corpus directory...]\n"
+        "\n"
+        "Parses generated sources and CMake files (CMakeLists.txt, *.cmake)\n"
+        "found in corpus directories and reports parser throughput.\n",
+        program
+    );
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Entry point.
+ *
+ * @param argc
+ * @param argv
+ *
+ * @return Exit code.
+ */
+int main(int argc, char** argv)
+{
+    wxInitializer initializer;
+
+    if (!initializer.IsOk()) {
+        fprintf(stderr, "Unable to initialize wxWidgets\n");
+        return 1;
+    }
+
+    size_t iterations = 10;
+    wxArrayString directories;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            iterations = strtoul(argv[++i], NULL, 10);
+        } else if (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
+            PrintUsage(argv[0]);
+            return 0;
+        } else {
+            directories.Add(wxString(argv[i]));
+        }
+    }
+
+    if (!iterations) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    printf("%-12s %10s %10s %10s %10s %12s %12s %12s\n",
+        "input", "size MB", "commands", "ms/iter", "MB/s", "commands/s",
+        "allocs/iter", "kB/iter");
+
+    // Generated sources
+    PrintResult("commands", BenchSource(GenerateCommands(50000), iterations), iterations);
+    PrintResult("nesting", BenchSource(GenerateNesting(500, 1000), iterations), iterations);
+    PrintResult("arguments", BenchSource(GenerateArguments(10, 20000), iterations), iterations);
+    PrintResult("comments", BenchSource(GenerateComments(100, 500), iterations), iterations);
+
+    // Real-world corpus
+    if (!directories.IsEmpty()) {
+        wxArrayString files;
+
+        for (size_t i = 0; i < directories.GetCount(); ++i) {
+            wxDir::GetAllFiles(directories[i], &files, "CMakeLists.txt");
+            wxDir::GetAllFiles(directories[i], &files, "*.cmake");
+        }
+
+        printf("corpus: %u files\n", static_cast<unsigned>(files.GetCount()));
+        PrintResult("corpus", BenchFiles(files, iterations), iterations);
+    }
+
+    printf("peak RSS: %u kB\n", static_cast<unsigned>(GetPeakRss()));
+
+    return 0;
+}
+
+/* ************************************************************************ */
@@ -0,0 +1,337 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// C++
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+// wxWidgets
+#include <wx/init.h>
+#include <wx/string.h>
+#include <wx/filename.h>
+#include <wx/stopwatch.h>
+
+// CMakePlugin
+#include "../CMake.h"
+#include "../CMakeParser.h"
+#include "../CMakeMappedFile.h"
+#include "../CMakeAnalyzer.h"
+#include "../CMakeVariableIndex.h"
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Returns line number of the position.
+ *
+ * @param data Source.
+ * @param size Source size.
+ * @param pos  Position in the source.
+ *
+ * @return Line number (from 1).
+ */
+static unsigned GetLine(const char* data, size_t size, size_t pos)
+{
+    pos = std::min(pos, size);
+    return 1 + std::count(data, data + pos, '\n');
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Parses files and prints errors.
+ *
+ * @param argc Number of files.
+ * @param argv Files.
+ *
+ * @return Exit code.
+ */
+static int Parse(int argc, char** argv)
+{
+    int result = 0;
+
+    for (int i = 0; i < argc; ++i) {
+        CMakeParser parser;
+        wxStopWatch watch;
+
+        if (!parser.ParseFile(wxFileName(argv[i]))) {
+            fprintf(stderr, "%s: unable to open\n", argv[i]);
+            result = 1;
+            continue;
+        }
+
+        const long time = watch.Time();
+        const wxVector<CMakeParser::Error>& errors = parser.GetErrors();
+
+        for (wxVector<CMakeParser::Error>::const_iterator it = errors.begin(),
+            ite = errors.end(); it != ite; ++it) {
+            printf("%s:%u: %s\n", argv[i], GetLine(parser.GetData(), parser.GetSize(), it->pos),
+                CMakeParser::GetError(it->code).utf8_str().data());
+        }
+
+        printf("%s: %u commands, %u errors, %ld ms\n", argv[i],
+            static_cast<unsigned>(parser.GetCommands().size()),
+            static_cast<unsigned>(errors.size()), time);
+
+        if (!errors.empty())
+            result = 1;
+    }
+
+    return result;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Analyzes project and prints its files.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments (root CMakeLists.txt).
+ *
+ * @return Exit code.
+ */
+static int Analyze(int argc, char** argv)
+{
+    if (argc != 1)
+        return 2;
+
+    CMakeAnalyzer analyzer;
+    wxStopWatch watch;
+
+    if (!analyzer.Analyze(wxFileName(argv[0]))) {
+        fprintf(stderr, "%s: unable to parse\n", argv[0]);
+        return 1;
+    }
+
+    const long time = watch.Time();
+
+    for (size_t i = 0; i < analyzer.GetFileCount(); ++i) {
+        const CMakeAnalyzer::File& file = analyzer.GetFile(i);
+
+        printf("%s: %u commands, %u links\n",
+            file.path.utf8_str().data(),
+            static_cast<unsigned>(file.parser.GetCommands().size()),
+            static_cast<unsigned>(file.links.size()));
+    }
+
+    printf("%u files, %u variables, %ld ms\n",
+        static_cast<unsigned>(analyzer.GetFileCount()),
+        static_cast<unsigned>(analyzer.GetVariables().size()), time);
+
+    return 0;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Prints locations of variable references.
+ *
+ * @param index     Variable index.
+ * @param kind      Printed kind of references.
+ * @param locations Locations.
+ */
+static void PrintLocations(const CMakeVariableIndex& index, const char* kind,
+                           const wxVector<CMakeVariableIndex::Location>& locations)
+{
+    for (wxVector<CMakeVariableIndex::Location>::const_iterator it = locations.begin(),
+        ite = locations.end(); it != ite; ++it) {
+        const wxString& path = index.GetPath(it->file);
+
+        // Analyzer doesn't keep sources
+        CMakeMappedFile file;
+
+        if (!file.Open(path))
+            continue;
+
+        printf("%s:%u: %s\n", path.utf8_str().data(),
+            GetLine(file.GetData(), file.GetSize(), it->pos), kind);
+    }
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Prints definitions and uses of variable.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments (root CMakeLists.txt and variable name).
+ *
+ * @return Exit code.
+ */
+static int References(int argc, char** argv)
+{
+    if (argc != 2)
+        return 2;
+
+    CMakeAnalyzer analyzer;
+
+    if (!analyzer.Analyze(wxFileName(argv[0]))) {
+        fprintf(stderr, "%s: unable to parse\n", argv[0]);
+        return 1;
+    }
+
+    CMakeVariableIndex index;
+
+    for (size_t i = 0; i < analyzer.GetFileCount(); ++i) {
+        if (analyzer.GetFile(i).parsed)
+            index.Update(analyzer.GetFile(i).parser);
+    }
+
+    const CMakeSymbols::Id name = CMakeSymbols::Get().Find(wxString::FromUTF8(argv[1]));
+
+    if (name == CMakeSymbols::InvalidId)
+        return 1;
+
+    PrintLocations(index, "definition", index.GetDefinitions(name));
+    PrintLocations(index, "use", index.GetUses(name));
+
+    return 0;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Loads CMake help and searches in it.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments ([-f] [-c cmake] [search text]).
+ *
+ * @return Exit code.
+ */
+static int Help(int argc, char** argv)
+{
+    bool force = false;
+    wxFileName path;
+    wxString text;
+
+    for (int i = 0; i < argc; ++i) {
+        if (!strcmp(argv[i], "-f")) {
+            force = true;
+        } else if (!strcmp(argv[i], "-c") && i + 1 < argc) {
+            path = wxFileName(argv[++i]);
+        } else {
+            if (!text.IsEmpty())
+                text << " ";
+
+            text << wxString::FromUTF8(argv[i]);
+        }
+    }
+
+    CMake cmake(path);
+    wxStopWatch watch;
+
+    if (!cmake.LoadData(force)) {
+        fprintf(stderr, "unable to load CMake help\n");
+        return 1;
+    }
+
+    printf("CMake %s: %u commands, %u modules, %u properties, %u variables, %ld ms\n",
+        cmake.GetVersion().utf8_str().data(),
+        static_cast<unsigned>(cmake.GetCommands().size()),
+        static_cast<unsigned>(cmake.GetModules().size()),
+        static_cast<unsigned>(cmake.GetProperties().size()),
+        static_cast<unsigned>(cmake.GetVariables().size()),
+        watch.Time());
+
+    if (text.IsEmpty())
+        return 0;
+
+    const CMake::SearchResult hits = cmake.Search(text);
+
+    for (CMake::SearchResult::const_iterator it = hits.begin(),
+        ite = hits.end(); it != ite; ++it) {
+        printf("%s\n", it->name.utf8_str().data());
+    }
+
+    return 0;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Prints usage.
+ *
+ * @param program Program name.
+ */
+static void PrintUsage(const char* program)
+{
+    printf(
+        "Usage: %s <command> [arguments]\n"
+        "\n"
+        "Commands:\n"
+        "  parse <file>...                     parse files and print errors\n"
+        "  analyze <CMakeLists.txt>            print files of the project\n"
+        "  refs <CMakeLists.txt> <variable>    print definitions and uses of variable\n"
+        "  help [-f] [-c cmake] [text]         load CMake help (-f from cmake) and search\n",
+        program
+    );
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Entry point.
+ *
+ * @param argc
+ * @param argv
+ *
+ * @return Exit code.
+ */
+int main(int argc, char** argv)
+{
+    wxInitializer initializer;
+
+    if (!initializer.IsOk()) {
+        fprintf(stderr, "Unable to initialize wxWidgets\n");
+        return 1;
+    }
+
+    if (argc < 2) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    const char* command = argv[1];
+    int result = 2;
+
+    if (!strcmp(command, "parse"))
+        result = Parse(argc - 2, argv + 2);
+    else if (!strcmp(command, "analyze"))
+        result = Analyze(argc - 2, argv + 2);
+    else if (!strcmp(command, "refs"))
+        result = References(argc - 2, argv + 2);
+    else if (!strcmp(command, "help"))
+        result = Help(argc - 2, argv + 2);
+
+    // Invalid arguments
+    if (result == 2)
+        PrintUsage(argv[0]);
+
+    return result;
+}
+
+/* ************************************************************************ */
@@ -0,0 +1,132 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* CMakePlugin for Codelite                                                 */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* This program is free software: you can redistribute it and/or modify     */
+/* it under the terms of the GNU General Public License as published by     */
+/* the Free Software Foundation, either version 3 of the License, or        */
+/* (at your option) any later version.                                      */
+/*                                                                          */
+/* This program is distributed in the hope that it will be useful,          */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the             */
+/* GNU General Public License for more details.                             */
+/*                                                                          */
+/* You should have received a copy of the GNU General Public License        */
+/* along with this program. If not, see <http://www.gnu.org/licenses/>.     */
+/*                                                                          */
+/* ************************************************************************ */
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// C++
+#include <cstdio>
+#include <algorithm>
+
+// wxWidgets
+#include <wx/init.h>
+#include <wx/string.h>
+#include <wx/filename.h>
+
+// CMakePlugin
+#include "../CMakeParser.h"
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Prints item of the parsed source.
+ *
+ * Position is printed as line:column (both from 1, column in bytes).
+ *
+ * @param parser Parser with the source.
+ * @param pos    Position of the item.
+ * @param kind   Item kind.
+ * @param text   Item text.
+ */
+static void PrintItem(const CMakeParser& parser, size_t pos, const char* kind,
+                      const wxString& text)
+{
+    const char* data = parser.GetData();
+    pos = std::min(pos, parser.GetSize());
+
+    size_t start = pos;
+
+    while (start > 0 && data[start - 1] != '\n')
+        --start;
+
+    const unsigned line = 1 + std::count(data, data + start, '\n');
+
+    printf("%u:%u %s %s\n", line, unsigned(1 + pos - start), kind,
+        text.utf8_str().data());
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Entry point.
+ *
+ * Parses the file and prints commands, arguments, variable references
+ * and errors in stable format, one per line. Used by the parser conformance tests.
+ *
+ * @param argc
+ * @param argv
+ *
+ * @return Exit code.
+ */
+int main(int argc, char** argv)
+{
+    wxInitializer initializer;
+
+    if (!initializer.IsOk()) {
+        fprintf(stderr, "Unable to initialize wxWidgets\n");
+        return 1;
+    }
+
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <file>\n", argv[0]);
+        return 2;
+    }
+
+    CMakeParser parser;
+
+    if (!parser.ParseFile(wxFileName(argv[1]))) {
+        fprintf(stderr, "%s: unable to open\n", argv[1]);
+        return 1;
+    }
+
+    const wxVector<CMakeParser::Command>& commands = parser.GetCommands();
+
+    for (wxVector<CMakeParser::Command>::const_iterator it = commands.begin(),
+        ite = commands.end(); it != ite; ++it) {
+        PrintItem(parser, it->pos, "command", parser.GetName(*it));
+
+        for (size_t i = 0; i < it->argumentCount; ++i) {
+            PrintItem(parser, parser.GetArgumentSpan(*it, i).pos, "argument",
+                parser.GetArgument(*it, i));
+        }
+    }
+
+    const wxVector<CMakeParser::Reference>& references = parser.GetReferences();
+
+    for (wxVector<CMakeParser::Reference>::const_iterator it = references.begin(),
+        ite = references.end(); it != ite; ++it) {
+        PrintItem(parser, it->pos, it->definition ? "definition" : "use",
+            CMakeSymbols::Get().GetName(it->name));
+    }
+
+    const wxVector<CMakeParser::Error>& errors = parser.GetErrors();
+
+    for (wxVector<CMakeParser::Error>::const_iterator it = errors.begin(),
+        ite = errors.end(); it != ite; ++it) {
+        PrintItem(parser, it->pos, "error", CMakeParser::GetError(it->code));
+    }
+
+    return 0;
+}
+
+/* ************************************************************************ */
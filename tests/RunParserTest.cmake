@@ -0,0 +1,23 @@
+#
+# Runs parser conformance test: dumps the parsed input by cmakeparser_dump
+# and compares the result with the expected output.
+#
+# Variables: DUMP (path to cmakeparser_dump), INPUT (.cmake file),
+# EXPECTED (file with expected output).
+#
+
+execute_process(
+    COMMAND "${DUMP}" "${INPUT}"
+    OUTPUT_VARIABLE output
+    RESULT_VARIABLE result
+)
+
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "Unable to dump '${INPUT}': ${result}")
+endif (NOT result EQUAL 0)
+
+file(READ "${EXPECTED}" expected)
+
+if (NOT output STREQUAL expected)
+    message(FATAL_ERROR "Unexpected output of '${INPUT}':\n${output}\nExpected:\n${expected}")
+endif (NOT output STREQUAL expected)
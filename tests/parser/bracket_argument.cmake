@@ -0,0 +1,8 @@
+message([[simple]])
+message([=[contains ]] and ]==] but not the closing]=])
+message([==[
+multi
+line
+]==])
+message([[${NOT_A_REFERENCE}]])
+message(before[[not a bracket]]after)
@@ -0,0 +1,8 @@
+#[[ bracket comment
+set(HIDDEN 1) ]]
+#[=[ level one ]] still comment ]=]
+set(AFTER_COMMENT 1)
+# [[ line comment, not a bracket
+set(LINE 1)
+message(a #[[inline]] b)
+#[==[ closed only at level two ]=] ]==]
@@ -0,0 +1,8 @@
+set(QUOTE "a\"b")
+set(BACKSLASH "c:\\path\\")
+set(CONTROL "\t\r\n\;")
+set(CONTINUATION "first \
+second")
+set(ESCAPED "\${NOT_A_REFERENCE} ${REFERENCE}")
+set(NESTED "${OUTER_${INNER}}")
+set("QUOTED_NAME" "${QUOTED_NAME}")
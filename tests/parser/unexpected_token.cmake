@@ -0,0 +1,4 @@
+set "x" ()
+foo(x) "bar"
+set()
+trailing
\ No newline at end of file
@@ -0,0 +1,3 @@
+set(BEFORE 1)
+message([=[ never closed ]] ]==]
+set(AFTER 1)
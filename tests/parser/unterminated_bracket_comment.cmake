@@ -0,0 +1,3 @@
+set(BEFORE 1)
+#[[ comment is never closed
+set(HIDDEN 1)
@@ -0,0 +1,3 @@
+set(BEFORE 1)
+set(VALUE "never closed \")
+set(HIDDEN 1)